@@ -14,10 +14,14 @@
 class ActionInitialization : public G4VUserActionInitialization
 {
 public:
-        ActionInitialization();
+        // interactive : session avec visualisation (trajectoires stockées par défaut)
+        explicit ActionInitialization(G4bool interactive = false);
         ~ActionInitialization();
 
         virtual void Build() const;
         virtual void BuildForMaster() const;
+
+private:
+        G4bool fInteractive;
 };
 #endif
@@ -0,0 +1,43 @@
+#ifndef ALIASTABLE_HH
+#define ALIASTABLE_HH
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+// AliasTable : tirage d'un indice discret en O(1) (méthode d'alias de
+// Walker, construction de Vose en O(n))
+//
+//  Construite une fois à partir de poids >= 0 (non normalisés), puis lue
+//  seule : partageable entre threads. Un seul nombre aléatoire u dans [0,1[
+//  suffit : la partie entière de u*n choisit la colonne, la partie
+//  fractionnaire est comparée au seuil de la colonne (sinon son alias).
+// ============================================================================
+class AliasTable
+{
+public:
+    AliasTable() = default;
+    explicit AliasTable(const std::vector<G4double>& weights) { Build(weights); }
+
+    // Table reconstruite ; somme des poids nulle ou négative -> table vide
+    void Build(const std::vector<G4double>& weights);
+
+    inline std::size_t Size() const  { return fThreshold.size(); }
+    inline G4bool      Empty() const { return fThreshold.empty(); }
+
+    // Indice tiré avec la probabilité poids[i] / somme (u uniforme dans [0,1[)
+    inline std::size_t Sample(G4double u) const {
+        const G4double x = u * fThreshold.size();
+        std::size_t i = static_cast<std::size_t>(x);
+        if (i >= fThreshold.size()) i = fThreshold.size() - 1;
+        return (x - i < fThreshold[i]) ? i : fAlias[i];
+    }
+
+private:
+    std::vector<G4double>      fThreshold;   // seuil de chaque colonne, dans [0,1]
+    std::vector<std::uint32_t> fAlias;       // indice alias de chaque colonne
+};
+
+#endif
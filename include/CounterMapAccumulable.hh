@@ -0,0 +1,50 @@
+#ifndef COUNTERMAPACCUMULABLE_HH
+#define COUNTERMAPACCUMULABLE_HH
+
+#include "G4VAccumulable.hh"
+#include "G4Version.hh"
+#include "globals.hh"
+
+#include <map>
+#include <string>
+
+// ============================================================================
+// Accumulable "clé -> compteur" (ex. pertes de primaires par processus / matériau),
+// avec une somme réelle optionnelle par clé
+//
+// Chaque thread remplit sa propre instance (enregistrée dans SON
+// G4AccumulableManager par RunAction). En fin de run,
+// G4AccumulableManager::Merge() additionne les maps des workers dans
+// l'instance du master : aucun verrou n'est pris pendant la boucle d'événements.
+// ============================================================================
+class CounterMapAccumulable : public G4VAccumulable
+{
+public:
+    explicit CounterMapAccumulable(const G4String& name = "")
+    : G4VAccumulable(name) {}
+    ~CounterMapAccumulable() override = default;
+
+    void Increment(const std::string& key, G4long n = 1) { fCounts[key] += n; }
+    // Somme réelle associée à la clé (ex. énergie des tracks arrêtés par volume)
+    void AddSum(const std::string& key, G4double value) { fSums[key] += value; }
+
+    const std::map<std::string, G4long>& GetCounts() const { return fCounts; }
+    G4double GetSum(const std::string& key) const {
+        const auto it = fSums.find(key);
+        return (it != fSums.end()) ? it->second : 0.;
+    }
+    G4bool IsEmpty() const { return fCounts.empty(); }
+
+    // Interface G4VAccumulable
+    void Merge(const G4VAccumulable& other) override;
+    void Reset() override;
+#if G4VERSION_NUMBER >= 1130
+    void Print(G4PrintOptions options = G4PrintOptions()) const override;
+#endif
+
+private:
+    std::map<std::string, G4long> fCounts;
+    std::map<std::string, G4double> fSums;
+};
+
+#endif
@@ -41,6 +41,10 @@ class DetectorConstruction : public G4VUserDetectorConstruction{
         // =====================================================
         G4LogicalVolume* GetAnodeLogicalVolume() const { return fLogicAnode; }
         G4VPhysicalVolume* GetAnodePhysicalVolume() const { return fPhysAnode; }
+
+        // Numéro de la géométrie construite (incrémenté à chaque Construct()) :
+        // les tables dérivées de l'anode se reconstruisent quand il change
+        G4int GetGeometryVersion() const { return fGeometryVersion; }
         
         // Retourne le solide de l'anode pour le test Inside()
         G4VSolid* GetAnodeSolid() const;
@@ -57,6 +61,26 @@ class DetectorConstruction : public G4VUserDetectorConstruction{
         G4LogicalVolume* GetWaterRingLogicalVolume(G4int ringIndex) const;
         G4int GetNumberOfWaterRings() const { return kNbWaterRings; }
 
+        // =====================================================
+        // Biais forced collision (Compton) dans logicConeCompton (option -f)
+        // =====================================================
+        void SetForcedCompton(G4bool on) { fForcedCompton = on; }
+        G4bool GetForcedCompton() const { return fForcedCompton; }
+
+        // =====================================================
+        // Splitting directionnel du bremsstrahlung dans l'anode (option -b) :
+        // région dédiée à fLogicAnode, mêmes cuts que la région du monde
+        // =====================================================
+        static constexpr const char* kAnodeRegionName = "AnodeRegion";
+        void SetBremSplitting(G4bool on) { fBremSplitting = on; }
+        G4bool GetBremSplitting() const { return fBremSplitting; }
+
+        // =====================================================
+        // Demi-largeur transverse (x, y) de logicEnveloppeGDML : bord des
+        // scoreurs, repris par TrackKiller et les tranches d'importance
+        // =====================================================
+        static constexpr G4double kEnveloppeHalfXY = 5.0*cm;
+
     private:
         void DefineMaterial();
         virtual void ConstructSDandField();
@@ -124,6 +148,15 @@ class DetectorConstruction : public G4VUserDetectorConstruction{
 
         G4bool fisGDML;
 
+        // Biais forced collision sur le cône graphite (opérateur créé par thread)
+        G4bool fForcedCompton = false;
+
+        // Région "AnodeRegion" créée pour le splitting du bremsstrahlung
+        G4bool fBremSplitting = false;
+
+        // Constructions successives (/run/reinitializeGeometry)
+        G4int fGeometryVersion = 0;
+
         // =====================================================
         // NOUVEAU : Pointeurs vers le volume de l'anode tungstène
         // =====================================================
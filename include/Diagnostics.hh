@@ -0,0 +1,51 @@
+#ifndef DIAGNOSTICS_HH
+#define DIAGNOSTICS_HH
+
+#include "globals.hh"
+#include "RunLedger.hh"
+
+// ============================================================================
+// Politique de diagnostics fixée à la compilation
+//
+//  SIM_DIAGNOSTICS est défini par CMake sur la cible sim :
+//    -DSIM_DIAGNOSTICS=ON  (défaut) : variante "debug", comportement habituel
+//                                     (logs [DEBUG], traces limitées, verbose) ;
+//    -DSIM_DIAGNOSTICS=OFF          : variante "production", toutes les
+//                                     branches de diagnostic sont éliminées.
+//
+//  Diag::kEnabled est constexpr : une condition "Diag::kEnabled && ..." ou un
+//  "if constexpr (Diag::kEnabled)" disparaît entièrement du binaire de
+//  production (pas de test de verbose, pas de compteur de log, pas de G4cout).
+//  Les compteurs utilisés par les BILANS (ledger, accumulables) ne passent
+//  jamais par ici : ils restent identiques dans les deux variantes.
+// ============================================================================
+#ifndef SIM_DIAGNOSTICS
+#define SIM_DIAGNOSTICS 1
+#endif
+
+namespace Diag
+{
+    inline constexpr G4bool kEnabled = (SIM_DIAGNOSTICS != 0);
+
+    // Vrai si le niveau de verbose courant vaut "level" (toujours faux en production)
+    inline constexpr G4bool Verbose(G4int current, G4int level = 1) {
+        return kEnabled && current == level;
+    }
+
+    // Log limité aux n premiers passages (compteur "log" du ledger, par thread).
+    // En production le compteur n'est même pas incrémenté.
+    inline G4bool First(RunLedger* ledger, G4int slot, G4long n) {
+        if constexpr (kEnabled) {
+            return ledger->Add(slot) < n;
+        } else {
+            (void)ledger; (void)slot; (void)n;
+            return false;
+        }
+    }
+
+    inline constexpr const char* Variant() {
+        return kEnabled ? "debug" : "production";
+    }
+}
+
+#endif
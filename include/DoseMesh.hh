@@ -0,0 +1,149 @@
+#ifndef DOSEMESH_HH
+#define DOSEMESH_HH
+
+#include "G4VAccumulable.hh"
+#include "G4ThreeVector.hh"
+#include "G4Version.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class DoseMeshMessenger;
+
+// ============================================================================
+// DoseMesh : maillage 3D de dose (énergie déposée et somme des carrés par
+//            voxel), creux par blocs, au-dessus du conteneur d'eau
+//
+//  Configuration (macro /dosemesh/, fixée avant le run, partagée par les
+//  threads) :
+//    /dosemesh/enable true|false
+//    /dosemesh/center <x y z> mm      centre de la boîte (défaut : eau + PVC)
+//    /dosemesh/halfSize <x y z> mm    demi-dimensions
+//    /dosemesh/voxelSize <x y z> mm   pas (arrondi : la boîte contient un
+//                                     nombre entier de voxels, même centre)
+//    /dosemesh/output <nom>           fichier <nom>.dose
+//
+//  Stockage : la grille est découpée en blocs de 4x4x4 voxels ; seul un
+//  répertoire d'entiers (un par bloc) est dense, les blocs ne sont alloués
+//  qu'au premier dépôt. La mémoire suit donc les voxels touchés.
+//
+//  Incertitudes : un primaire (slot MyTrackInfo) est une histoire
+//  indépendante, comme pour les anneaux d'eau. Les dépôts du primaire en
+//  cours sont cumulés dans le bloc ; à chaque changement de slot ils passent
+//  dans une liste de l'événement, puis EndEvent() ajoute e et e² par couple
+//  (voxel, slot) aux sommes des seuls voxels touchés.
+//
+//  Normalisation : par primaire de la source ; en rejeu d'espace des phases
+//  (source 4), par primaire équivalent de l'étape 1
+//  (PhaseSpace::GetEquivalentPrimaries()), pas par histoire du fichier.
+//
+//  Chaque thread remplit son instance (accumulable de RunAction) ;
+//  G4AccumulableManager::Merge() additionne les blocs des workers sur le
+//  master, qui écrit le fichier (EndRun).
+//
+//  Format binaire (petit-boutiste, natif) :
+//    en-tête  "DOS1" | uint32 version (2) | uint32 nx, ny, nz
+//             | float64 x0, y0, z0 (mm, coin inférieur) | float64 dx, dy, dz (mm)
+//             | uint64 histoires (primaires simulés, base de la variance)
+//             | uint64 primaires de normalisation (= histoires, sauf rejeu :
+//               primaires équivalents de l'étape 1) | uint64 enregistrements
+//    enregistrement (16 octets), voxels touchés seulement :
+//             uint32 index = ix + nx*(iy + ny*iz) | float32 dose (Gy par primaire)
+//             | float32 écart-type (Gy par primaire) | float32 densité (g/cm3)
+//  La masse d'un voxel est celle du matériau en son centre (approximation
+//  pour les voxels à cheval sur une frontière).
+// ============================================================================
+class DoseMesh : public G4VAccumulable
+{
+public:
+    explicit DoseMesh(const G4String& name = "DoseMesh")
+    : G4VAccumulable(name) {}
+    ~DoseMesh() override = default;
+
+    // Messenger /dosemesh/ (master / SEQ uniquement, sans effet ailleurs)
+    static void Init();
+
+    // ----- Configuration (master, avant le run) -----
+    static void SetEnabled(G4bool on)                  { fEnabled = on; }
+    static void SetCenter(const G4ThreeVector& c)      { fCenter = c; }
+    static void SetHalfSize(const G4ThreeVector& h)    { fHalfSize = h; }
+    static void SetVoxelSize(const G4ThreeVector& v)   { fVoxelSize = v; }
+    static void SetOutput(const G4String& base)        { fOutputBase = base; }
+
+    static inline G4bool IsEnabled()                   { return fEnabled; }
+    static inline const G4ThreeVector& GetCenter()     { return fCenter; }
+    static inline const G4ThreeVector& GetHalfSize()   { return fHalfSize; }
+    static inline const G4ThreeVector& GetVoxelSize()  { return fVoxelSize; }
+
+    // Début de run (chaque thread, après G4AccumulableManager::Reset()) : grille
+    void BeginRun();
+    // Fin de run (master / SEQ, après Merge()) : fichier <output>.dose et bilan
+    void EndRun();
+
+    // Dépôt pondéré (keV) au point pos, primaire slot ; ignoré hors de la boîte
+    void Deposit(const G4ThreeVector& pos, G4double edep_keV, G4int slot);
+    // Fin d'événement (nSlots primaires) : e et e² par histoire -> sommes du run
+    void EndEvent(G4int nSlots);
+
+    // Interface G4VAccumulable
+    void Merge(const G4VAccumulable& other) override;
+    void Reset() override;
+#if G4VERSION_NUMBER >= 1130
+    void Print(G4PrintOptions options = G4PrintOptions()) const override;
+#endif
+
+private:
+    static constexpr G4int kBlockEdge = 4;
+    static constexpr G4int kBlockSize = kBlockEdge * kBlockEdge * kBlockEdge;
+    // Index de voxel sur 32 bits dans le fichier
+    static constexpr std::uint64_t kMaxVoxels = 0xFFFFFFFFull;
+
+    struct Block {
+        std::uint32_t id = 0;              // rang du bloc dans la grille de blocs
+        G4double sum[kBlockSize]   = {};   // somme des e par histoire (keV)
+        G4double sum2[kBlockSize]  = {};   // somme des e² (keV²)
+        G4double event[kBlockSize] = {};   // primaire en cours
+    };
+
+    struct Touched {
+        std::uint32_t block;               // rang dans fBlocks
+        std::uint32_t offset;              // voxel dans le bloc
+    };
+
+    struct Staged {
+        std::uint32_t block;
+        std::uint32_t offset;
+        G4int         slot;                // primaire de l'événement
+        G4double      e;                   // keV
+    };
+
+    // Bloc d'identifiant id (alloué si absent), rang dans fBlocks
+    std::uint32_t BlockSlot(std::uint32_t id);
+    // Dépôts du primaire en cours (fSlot) -> fStaged
+    void StageSlot();
+
+    // ----- Configuration partagée -----
+    static G4bool        fEnabled;
+    static G4ThreeVector fCenter;
+    static G4ThreeVector fHalfSize;
+    static G4ThreeVector fVoxelSize;
+    static G4String      fOutputBase;
+    static DoseMeshMessenger* fMessenger;
+
+    // ----- Grille du run (identique sur tous les threads) -----
+    G4int         fNx = 0, fNy = 0, fNz = 0;
+    G4int         fNbx = 0, fNby = 0, fNbz = 0;   // blocs par axe
+    G4ThreeVector fOrigin;                        // coin inférieur
+    G4ThreeVector fPitch;
+
+    // ----- Données du thread -----
+    std::vector<G4int>   fDirectory;   // bloc -> rang dans fBlocks, -1 si non alloué
+    std::vector<Block>   fBlocks;
+    std::vector<Touched> fTouched;     // voxels touchés par le primaire en cours
+    std::vector<Staged>  fStaged;      // primaires précédents de l'événement
+    G4int                fSlot = 0;    // primaire en cours
+    std::uint64_t        fHistories = 0;
+};
+
+#endif
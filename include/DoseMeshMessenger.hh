@@ -0,0 +1,28 @@
+#ifndef DoseMeshMessenger_h
+#define DoseMeshMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWith3VectorAndUnit;
+
+class DoseMeshMessenger : public G4UImessenger {
+public:
+    DoseMeshMessenger();
+    virtual ~DoseMeshMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWith3VectorAndUnit* fCenterCmd;
+    G4UIcmdWith3VectorAndUnit* fHalfSizeCmd;
+    G4UIcmdWith3VectorAndUnit* fVoxelSizeCmd;
+    G4UIcmdWithAString* fOutputCmd;
+};
+
+#endif
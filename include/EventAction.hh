@@ -7,8 +7,11 @@
 #include "MyTrackInfo.hh"
 #include "g4root_defs.hh"
 
+#include <vector>
+
 class G4Event;
 class RunAction;
+class StepTracer;
 
 class EventAction : public G4UserEventAction
 {
@@ -45,27 +48,35 @@ public:
     // ==================== Énergie déposée dans les anneaux d'eau ====================
     static const G4int kNbWaterRings = 5;
     
-    // Ajouter de l'énergie déposée dans un anneau spécifique
-    void AddEdepToRing(G4int ringIndex, G4double edep) {
+    // Ajouter de l'énergie déposée dans un anneau spécifique,
+    // pondérée par le poids de la track (1 en analogue), au score du
+    // primaire "slot" de l'événement (MyTrackInfo::GetPrimarySlot)
+    void AddEdepToRing(G4int ringIndex, G4double edep, G4double weight = 1., G4int slot = 0) {
         if (ringIndex >= 0 && ringIndex < kNbWaterRings) {
-            fEdepRing[ringIndex] += edep;
-            fEdepTotalWater += edep;
+            PrimaryScore& score = ScoreOf(slot);
+            score.edepRing[ringIndex] += weight * edep;
+            score.edepTotal += weight * edep;
         }
     }
     
-    // Accesseurs pour l'énergie déposée
-    G4double GetEdepRing(G4int ringIndex) const {
-        if (ringIndex >= 0 && ringIndex < kNbWaterRings) return fEdepRing[ringIndex];
-        return 0.0;
+    // Accesseurs pour l'énergie déposée (somme des primaires de l'événement)
+    G4double GetEdepRing(G4int ringIndex) const;
+    G4double GetEdepTotalWater() const;
+
+    // Kerma par longueur de trace des photons dans un anneau (keV, pondéré)
+    void AddKermaToRing(G4int ringIndex, G4double kerma, G4int slot = 0) {
+        if (ringIndex >= 0 && ringIndex < kNbWaterRings) ScoreOf(slot).kermaRing[ringIndex] += kerma;
     }
-    G4double GetEdepTotalWater() const { return fEdepTotalWater; }
 
 
 private:
 
     G4bool enteredCube = false;
     G4bool enteredSphere = false;
-    G4String creatorProcess = "unknown";
+    // [FIX] Pointeur vers le nom tenu par le G4VProcess (ou le "primary" statique
+    //       de MyTrackInfo) : plus de copie de G4String à chaque SetTrackInfo.
+    //       nullptr = pas encore renseigné dans l'événement ("unknown").
+    const G4String* creatorProcess = nullptr;
 
     // Compteurs pour Beryllium
     G4int fNbInteractedInBe = 0;
@@ -76,6 +87,7 @@ private:
     G4int fNbInteractedInWaterSphere = 0;
 
     RunAction* fRunAction = nullptr;
+    StepTracer* fTracer = nullptr;   // suivi step par step (propre au thread)
 
     G4int fEventVerboseLevel = 0;
 
@@ -85,9 +97,20 @@ private:
     G4double ma   = 0.0;
     G4String mo   = "none";
 
-    // Énergie déposée dans les anneaux d'eau (par événement)
-    G4double fEdepRing[kNbWaterRings] = {0.0, 0.0, 0.0, 0.0, 0.0};
-    G4double fEdepTotalWater = 0.0;
+    // Scores d'une histoire (un primaire) : énergie déposée et kerma
+    // (longueur de trace x mu_en/rho) dans les anneaux d'eau
+    struct PrimaryScore {
+        G4double edepRing[kNbWaterRings]  = {0.0, 0.0, 0.0, 0.0, 0.0};
+        G4double edepTotal = 0.0;
+        G4double kermaRing[kNbWaterRings] = {0.0, 0.0, 0.0, 0.0, 0.0};
+    };
+    // Un score par primaire de l'événement (/primariesgenerator/primariesPerEvent),
+    // transmis séparément au RunAction : moyennes et variances restent par primaire
+    std::vector<PrimaryScore> fScores = std::vector<PrimaryScore>(1);
+
+    PrimaryScore& ScoreOf(G4int slot) {
+        return (slot > 0 && slot < static_cast<G4int>(fScores.size())) ? fScores[slot] : fScores[0];
+    }
 
 };
 #endif
@@ -0,0 +1,24 @@
+#ifndef ImportanceMessenger_h
+#define ImportanceMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithoutParameter;
+
+class ImportanceMessenger : public G4UImessenger {
+public:
+    ImportanceMessenger();
+    virtual ~ImportanceMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcommand* fSlabCmd;
+    G4UIcmdWithoutParameter* fListCmd;
+};
+
+#endif
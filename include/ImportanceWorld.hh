@@ -0,0 +1,67 @@
+#ifndef IMPORTANCEWORLD_HH
+#define IMPORTANCEWORLD_HH
+
+#include "G4VUserParallelWorld.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+class ImportanceMessenger;
+
+// ============================================================================
+// ImportanceWorld : monde parallèle de tranches en z pour le splitting /
+//                   roulette russe géométrique des photons (G4ImportanceBiasing)
+//
+//  Les tranches suivent le trajet du faisceau, de l'anode aux couronnes d'eau :
+//    0 source   [-60, 1.90] mm   anode, fenêtre Be, entrée du cône
+//    1 cone     [1.90, 16.95]    cône Compton graphite (logicConeCompton)
+//    2 plane1   [16.95, 23]      sortie du cône, ScorePlane (18 mm)
+//    3 plane2   [23, 33]         ScorePlane2 (28 mm)
+//    4 plane3   [33, 51.5]       ScorePlane3 (38 mm)
+//    5 drift    [51.5, 64]       air jusqu'au conteneur PVC
+//    6 water    [64, 72]         couronnes d'eau, fond PVC, ScorePlane5 (70 mm)
+//  Le reste du monde parallèle a l'importance 1.
+//
+//  Activé par l'option -i de sim (le monde parallèle et la physique de biais
+//  doivent être enregistrés avant /run/initialize). Les importances (1 par
+//  défaut = run analogue) sont réglées par macro, partagées par les threads :
+//    /importance/slab <index> <valeur>
+//    /importance/list
+//  et recopiées dans le G4IStore de chaque thread au début de chaque run.
+// ============================================================================
+class ImportanceWorld : public G4VUserParallelWorld
+{
+public:
+    static constexpr const char* kWorldName = "ImportanceWorld";
+
+    explicit ImportanceWorld(const G4String& worldName = kWorldName);
+    ~ImportanceWorld() override;
+
+    void Construct() override;
+    void ConstructSD() override;
+
+    // nullptr si le monde d'importance n'est pas enregistré (option -i absente)
+    static ImportanceWorld* Get() { return fInstance; }
+
+    // ----- Configuration (master, hors run) -----
+    static G4int  GetNumberOfSlabs();
+    static G4bool SetImportance(G4int slab, G4double importance);
+    static void   PrintImportances();
+
+    // Début de run : importances -> G4IStore du thread, liste imprimée (master/SEQ)
+    static void BeginRun();
+
+private:
+    // Remplit / met à jour le G4IStore du thread appelant
+    void ApplyToStore() const;
+
+    G4VPhysicalVolume* fGhostWorld = nullptr;
+    std::vector<G4VPhysicalVolume*> fSlabs;   // géométrie partagée (construite par le master)
+
+    static ImportanceWorld*      fInstance;
+    static std::vector<G4double> fImportances;
+    static ImportanceMessenger*  fMessenger;
+};
+
+#endif
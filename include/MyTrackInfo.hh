@@ -2,25 +2,45 @@
 #define MYTRACKINFO_HH
 
 #include "G4VUserTrackInformation.hh"
+#include "G4Track.hh"
 #include "G4ThreeVector.hh"
+#include "G4VProcess.hh"
+#include "G4Allocator.hh"
 #include "globals.hh"
 
+// ============================================================================
+// Informations utilisateur d'un track
+//
+//  - créées en TrackingAction::PreUserTrackingAction pour CHAQUE track,
+//    dans un pool G4Allocator propre au thread (convention Geant4, cf. SphereHit) ;
+//  - le processus créateur est gardé sous forme de pointeur (nul = primaire) :
+//    plus de copie de G4String par secondaire, le nom n'est lu qu'à l'affichage ;
+//  - les drapeaux booléens sont regroupés dans un champ de bits.
+// ============================================================================
 class MyTrackInfo : public G4VUserTrackInformation
 {
 public:
-    MyTrackInfo();
+    explicit MyTrackInfo(const G4VProcess* creator = nullptr);
+    // Copie : clone d'un photon par le biais "forced collision" (même lignée)
+    MyTrackInfo(const MyTrackInfo&) = default;
     virtual ~MyTrackInfo();
 
-    inline void SetEnteredCube(G4bool val) { enteredCube = val; }
-    inline G4bool HasEnteredCube() const { return enteredCube; }
+    // Allocateur thread-local (convention Geant4)
+    inline void* operator new(size_t);
+    inline void operator delete(void*);
 
-    void SetEnteredSphere(G4bool val) { enteredSphere = val; }
-    G4bool HasEnteredSphere() const { return enteredSphere; }
+    inline void SetEnteredCube(G4bool val) { fEnteredCube = val; }
+    inline G4bool HasEnteredCube() const { return fEnteredCube; }
 
-    // Processus créateur
-    void SetCreatorProcess(const G4String& name) { creatorProcess = name; }
-    G4String GetCreatorProcess() const {
-        return creatorProcess.empty() ? "unknown" : creatorProcess;
+    void SetEnteredSphere(G4bool val) { fEnteredSphere = val; }
+    G4bool HasEnteredSphere() const { return fEnteredSphere; }
+
+    // Processus créateur (nul pour un primaire)
+    const G4VProcess* GetCreatorProcessPtr() const { return fCreatorProcess; }
+    // Nom du processus créateur ("primary" pour un primaire) : affichage / bilans
+    const G4String& GetCreatorProcess() const {
+        static const G4String kPrimary = "primary";
+        return fCreatorProcess ? fCreatorProcess->GetProcessName() : kPrimary;
     }
 
     // ==================== Compton dans le cône graphite ====================
@@ -41,17 +61,71 @@ public:
     void     SetLastComptonEkin(G4double e)         { fLastComptonEkin = e; }
     G4double GetLastComptonEkin() const             { return fLastComptonEkin; }
 
+    // Poids statistique du track à la dernière diffusion Compton dans le cône
+    // (1 en analogue ; < 1 avec le biais forced collision, option -f)
+    void     SetLastComptonWeight(G4double w)       { fLastComptonWeight = w; }
+    G4double GetLastComptonWeight() const           { return fLastComptonWeight; }
+
+    // ==================== Biais forced collision ====================
+    // Clone créé à l'entrée du cône par G4BOptrForceCollision : secondaire pour
+    // Geant4 (parentID != 0) mais même photon physique que le primaire
+    void     SetBiasClone(G4bool val)               { fBiasClone = val; }
+    G4bool   IsBiasClone() const                    { return fBiasClone; }
+
+    // Primaire pour les sorties (is_secondary des ntuples, tallies _prim/_sec,
+    // marquage Compton) : primaire Geant4 ou clone d'un primaire
+    static inline G4bool IsPrimary(const G4Track* track) {
+        if (track->GetParentID() == 0) return true;
+        const auto* info = static_cast<const MyTrackInfo*>(track->GetUserInformation());
+        return info && info->IsBiasClone();
+    }
+
+    // ==================== Espace des phases ====================
+    // Track arrêté au plan de l'espace des phases (PhaseSpaceObserver) :
+    // pas une perte, l'aval est écrit dans le fichier ou déjà rejoué
+    void     SetStoppedAtPhaseSpace(G4bool val)     { fStoppedAtPsf = val; }
+    G4bool   IsStoppedAtPhaseSpace() const          { return fStoppedAtPsf; }
+
+    // ==================== Suivi step par step ====================
+    // Track appartenant à un événement échantillonné par StepTracer
+    void     SetTraced(G4bool val)                  { fTraced = val; }
+    G4bool   IsTraced() const                       { return fTraced; }
+
+    // ==================== Événements multi-photons ====================
+    // Rang du primaire (dans l'événement) dont descend ce track : les scores
+    // par histoire sont tenus par primaire (/primariesgenerator/primariesPerEvent)
+    void     SetPrimarySlot(G4int slot)             { fPrimarySlot = slot; }
+    G4int    GetPrimarySlot() const                 { return fPrimarySlot; }
+
 private:
-    G4bool enteredCube;
-    G4bool enteredSphere;
-    G4String creatorProcess;
+    const G4VProcess* fCreatorProcess;
 
     // Compton dans le cône
-    G4bool        fComptonInCone;
     G4int         fNComptonInCone;
     G4ThreeVector fLastComptonPos;
     G4double      fLastComptonEkin;
+    G4double      fLastComptonWeight;
+
+    G4int         fPrimarySlot;
 
+    // Drapeaux (champ de bits)
+    G4bool        fEnteredCube   : 1;
+    G4bool        fEnteredSphere : 1;
+    G4bool        fComptonInCone : 1;
+    G4bool        fTraced        : 1;
+    G4bool        fBiasClone     : 1;
+    G4bool        fStoppedAtPsf  : 1;
 };
 
+extern G4ThreadLocal G4Allocator<MyTrackInfo>* MyTrackInfoAllocator;
+
+inline void* MyTrackInfo::operator new(size_t){
+    if (!MyTrackInfoAllocator) MyTrackInfoAllocator = new G4Allocator<MyTrackInfo>;
+    return MyTrackInfoAllocator->MallocSingle();
+}
+
+inline void MyTrackInfo::operator delete(void* info){
+    MyTrackInfoAllocator->FreeSingle((MyTrackInfo*) info);
+}
+
 #endif // MYTRACKINFO_HH
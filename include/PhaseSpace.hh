@@ -0,0 +1,140 @@
+#ifndef PHASESPACE_HH
+#define PHASESPACE_HH
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class G4Run;
+class G4Step;
+class PhaseSpaceMessenger;
+
+// ============================================================================
+// PhaseSpace : simulation en deux étapes via un fichier d'espace des phases
+//              au plan z = planeZ, juste après la fenêtre Be
+//
+//  Étape 1 (/phasespace/write true) : chaque particule qui traverse le plan
+//  vers +z est enregistrée (type, position, direction, énergie, poids) puis
+//  arrêtée, avec les secondaires créés en aval dans le même step : le run ne
+//  simule que le tube (anode, vide, fenêtre Be). Les types hors format sont
+//  arrêtés sans écriture (compteur "dropped" de [PSF][COUNTS]) ; un primaire
+//  arrêté au plan n'est pas compté comme perdu. Un fichier par thread :
+//    <output>.psf (SEQ) ou <output>_t<N>.psf (worker N en MT).
+//
+//  Étape 2 (/primariesgenerator/selectsource 4) : PrimaryGeneratorAction4
+//  rejoue les histoires des fichiers /phasespace/addInput, chacune "reuse"
+//  fois (poids / reuse) avec une rotation azimutale aléatoire autour de z
+//  (géométrie du tube axisymétrique). Les rejeux d'une histoire sont corrélés :
+//  ils partagent un même primaire (même appel du générateur), donc une seule
+//  histoire statistique. Les particules qui repassent le plan vers -z sont
+//  arrêtées : l'amont est déjà dans le fichier. Les incertitudes du run
+//  n'incluent pas la variance propre au fichier (nombre fini d'histoires de
+//  l'étape 1) ; avec /phasespace/recycle, les passages successifs ne sont pas
+//  indépendants (avertissement [PSF] en fin de run).
+//
+//  Format binaire (petit-boutiste, natif) :
+//    en-tête  "PSF1" | uint32 version | float64 planeZ (mm)
+//             | uint64 primaires de l'étape 1 | uint64 histoires | uint64 enregistrements
+//    enregistrement (33 octets) : uint32 histoire | uint8 type (0 gamma, 1 e-, 2 e+)
+//             | float32 x, y (mm) | float32 ux, uy, uz | float32 E (keV) | float32 poids
+//  Les histoires sans particule au plan ne sont pas écrites : la normalisation
+//  utilise le nombre de primaires de l'en-tête.
+// ============================================================================
+class PhaseSpace
+{
+public:
+    enum ParticleType : std::uint8_t { kGamma = 0, kElectron, kPositron, kNbTypes };
+
+    struct Record {
+        std::uint32_t history = 0;
+        std::uint8_t  type    = kGamma;
+        G4ThreeVector position;      // z = plan
+        G4ThreeVector direction;
+        G4double      ekin    = 0.;
+        G4double      weight  = 1.;
+    };
+
+    // Messenger /phasespace/ (master / SEQ uniquement, sans effet ailleurs)
+    static void Init();
+
+    // ----- Configuration (master, avant le run) -----
+    static void SetWrite(G4bool on)               { fWrite = on; }
+    static void SetOutput(const G4String& base)   { fOutputBase = base; }
+    static void SetPlaneZ(G4double z)             { fPlaneZ = z; }
+    static void AddInput(const G4String& file)    { fInputs.push_back(file); }
+    static void ClearInputs()                     { fInputs.clear(); }
+    static void SetReuse(G4int n)                 { fReuse = (n > 0) ? n : 1; }
+    static void SetRotate(G4bool on)              { fRotate = on; }
+    static void SetRecycle(G4bool on)             { fRecycle = on; }
+
+    static inline G4bool   IsWriting()            { return fWrite; }
+    static inline G4bool   HasInputs()            { return !fInputs.empty(); }
+    static inline G4double GetPlaneZ()            { return fPlaneZ; }
+    static inline G4int    GetReuse()             { return fReuse; }
+    static inline G4bool   GetRotate()            { return fRotate; }
+
+    // Rejeu actif sur le thread courant (posé par PrimaryGeneratorAction4)
+    static inline G4bool IsReplaying()            { return fReplaying; }
+    static inline void   SetReplaying(G4bool on)  { fReplaying = on; }
+
+    // Début / fin de run : fichier du thread (écriture), lecteur partagé (master)
+    static void BeginRun();
+    static void EndRun(const G4Run* run);
+
+    // ----- Étape 1 : écriture (thread courant, une histoire par primaire) -----
+    static void Write(G4int eventID, G4int slot, const Record& rec);
+    static std::uint8_t TypeOf(const G4String& particleName, G4bool& known);
+
+    // ----- Étape 2 : lecture (tous threads, sous verrou) -----
+    // Histoire suivante ; false si les fichiers sont épuisés (sans /phasespace/recycle)
+    static G4bool NextHistory(std::vector<Record>& history);
+    // Primaires de l'étape 1 représentées par les histoires lues (master, rejeu)
+    static inline G4double GetEquivalentPrimaries() {
+        return (fInputHistories > 0)
+            ? G4double(fHistoriesRead) / G4double(fInputHistories) * G4double(fInputPrimaries) : 0.;
+    }
+    static const char* ParticleName(std::uint8_t type);
+
+private:
+    // ----- Configuration partagée -----
+    static G4bool      fWrite;
+    static G4String    fOutputBase;
+    static G4double    fPlaneZ;
+    static std::vector<G4String> fInputs;
+    static G4int       fReuse;
+    static G4bool      fRotate;
+    static G4bool      fRecycle;
+
+    static PhaseSpaceMessenger* fMessenger;
+
+    // ----- Écriture : état du thread -----
+    struct Writer {
+        std::ofstream file;
+        std::string   name;
+        G4int         lastEventID = -1;
+        G4int         lastSlot    = -1;
+        std::uint64_t histories = 0;
+        std::uint64_t records   = 0;
+    };
+    static G4ThreadLocal Writer* fWriter;
+    static G4ThreadLocal G4bool  fReplaying;
+
+    // ----- Lecture : état partagé (protégé par un mutex) -----
+    static G4bool OpenInput(std::size_t index);
+    static std::ifstream  fIn;
+    static std::size_t    fInputIndex;
+    static std::uint64_t  fRecordsLeft;      // dans le fichier courant
+    static G4double       fInputPlaneZ;      // plan du fichier courant (en-tête)
+    static G4bool         fHasPending;       // premier enregistrement de l'histoire suivante
+    static Record         fPending;
+    static std::uint64_t  fInputPrimaries;   // somme des en-têtes (normalisation)
+    static std::uint64_t  fInputHistories;
+    static std::uint64_t  fHistoriesRead;
+    static std::uint64_t  fPasses;           // passages complets sur les fichiers (recycle)
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef PhaseSpaceMessenger_h
+#define PhaseSpaceMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+class PhaseSpaceMessenger : public G4UImessenger {
+public:
+    PhaseSpaceMessenger();
+    virtual ~PhaseSpaceMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithABool* fWriteCmd;
+    G4UIcmdWithAString* fOutputCmd;
+    G4UIcmdWithADoubleAndUnit* fPlaneZCmd;
+    G4UIcmdWithAString* fAddInputCmd;
+    G4UIcmdWithoutParameter* fClearInputsCmd;
+    G4UIcmdWithAnInteger* fReuseCmd;
+    G4UIcmdWithABool* fRotateCmd;
+    G4UIcmdWithABool* fRecycleCmd;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef PLANETALLIES_HH
+#define PLANETALLIES_HH
+
+#include "globals.hh"
+
+class G4Track;
+class PlaneTalliesMessenger;
+
+// ============================================================================
+// PlaneTallies : tallies binnés des plans de comptage, alternative compacte
+//                aux ntuples de passages (une ligne par traversée)
+//
+//  Mode de sortie (macro /tallies/mode, fixé avant le run, partagé par les
+//  threads) :
+//    ntuple  : lignes *_passages seules (comportement historique, défaut) ;
+//    tallies : histogrammes seuls, les ntuples de passages sont désactivés
+//              (ni remplis ni écrits, aucune chaîne construite par traversée) ;
+//    both    : les deux, pour valider les tallies contre analyse_simulation.C.
+//
+//  Par plan (préfixe SP1, SP2, SP3, WR = couronnes d'eau, SP5), remplis par
+//  le SD du thread puis fusionnés par G4AnalysisManager à Write(), tous
+//  pondérés par G4Track::GetWeight() :
+//    <p>_E          énergie à la traversée, toutes particules (keV)
+//    <p>_E_prim     primaires (MyTrackInfo::IsPrimary : parentID == 0 ou clone -f)
+//    <p>_E_sec      secondaires
+//    <p>_E_compton  primaires redirigés par Compton dans le cône (sous-ensemble de _prim)
+//    <p>_r          rayon sqrt(x²+y²) (mm), toutes particules
+//    <p>_xy         carte x-y (mm), toutes particules (H2)
+// ============================================================================
+class PlaneTallies
+{
+public:
+    enum Mode : G4int { kNtuple = 0, kTallies, kBoth };
+
+    enum Plane : G4int {
+        kScorePlane = 0,   // SurfaceSpectrumSD, z = 18 mm
+        kScorePlane2,      // z = 28 mm
+        kScorePlane3,      // z = 38 mm
+        kWaterRings,       // ScorePlane4SD, couronnes d'eau
+        kScorePlane5,      // z = 70 mm
+        kNbPlanes
+    };
+
+    // Messenger /tallies/ (master / SEQ uniquement, sans effet ailleurs)
+    static void Init();
+
+    // ----- Configuration (master, avant le run) -----
+    static void SetMode(G4int mode)      { fMode = mode; }
+    static G4int GetMode()               { return fMode; }
+    static const char* ModeName(G4int mode);
+
+    static inline G4bool WriteRows()     { return fMode != kTallies; }
+    static inline G4bool FillTallies()   { return fMode != kNtuple; }
+
+    // Réservation des histogrammes (SetupAnalysis, chaque thread, après H0-H19)
+    static void Book();
+
+    // Début de run (chaque thread) : activation histogrammes / ntuples selon le mode
+    static void BeginRun();
+
+    // Une traversée acceptée du plan (positions en mm, énergie en keV)
+    static void Fill(G4int plane, const G4Track* track,
+                     G4double x_mm, G4double y_mm, G4double ekin_keV);
+
+private:
+    enum Histo : G4int { kE = 0, kEPrim, kESec, kECompton, kR, kNbH1 };
+
+    // Premiers IDs (identiques sur tous les threads : même ordre de réservation)
+    static G4int fFirstH1[kNbPlanes];
+    static G4int fH2[kNbPlanes];
+
+    static G4int fMode;
+    static PlaneTalliesMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef PlaneTalliesMessenger_h
+#define PlaneTalliesMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+
+class PlaneTalliesMessenger : public G4UImessenger {
+public:
+    PlaneTalliesMessenger();
+    virtual ~PlaneTalliesMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithAString* fModeCmd;
+};
+
+#endif
@@ -10,11 +10,14 @@
 #include "G4IonTable.hh"
 #include "globals.hh"
 
+#include <vector>
 
 class PrimaryGeneratorAction0;
 class PrimaryGeneratorAction1;
 class PrimaryGeneratorAction2;
 class PrimaryGeneratorAction3;
+class PrimaryGeneratorAction4;
+class PrimaryGeneratorAction5;
 class PrimaryGeneratorMessenger;
 
 class G4ParticleGun;
@@ -37,17 +40,43 @@ public:
     PrimaryGeneratorAction1*  GetAction1() { return fAction1; };
     PrimaryGeneratorAction2*  GetAction2() { return fAction2; };
     PrimaryGeneratorAction3*  GetAction3() { return fAction3; };
+    PrimaryGeneratorAction4*  GetAction4() { return fAction4; };
+    PrimaryGeneratorAction5*  GetAction5() { return fAction5; };
+
+    // Événements multi-photons (/primariesgenerator/primariesPerEvent N) :
+    // N primaires indépendants par G4Event, chacun avec son vertex, pour amortir
+    // le coût fixe d'un événement (actions utilisateur, SD, transfert au run).
+    void  SetPrimariesPerEvent(G4int n) { fPrimariesPerEvent = (n > 0) ? n : 1; }
+    G4int GetPrimariesPerEvent() const  { return fPrimariesPerEvent; }
+
+    // Primaires effectivement tirés dans l'événement courant (= histoires)
+    G4int GetNbPrimarySlots() const     { return fNbPrimarySlots; }
+    // Rang du primaire qui a créé la particule primaire de trackID donné
+    // (G4PrimaryTransformer numérote les particules primaires 1, 2, ... dans
+    //  l'ordre des vertex) ; 0 hors table
+    G4int GetPrimarySlot(G4int trackID) const {
+        const std::size_t i = static_cast<std::size_t>(trackID - 1);
+        return (trackID > 0 && i < fPrimarySlots.size()) ? fPrimarySlots[i] : 0;
+    }
 
 private:
+    void GenerateOne(G4Event*);
+
     G4ParticleGun *fParticleGun= nullptr;
 
     PrimaryGeneratorAction0* fAction0 = nullptr;
     PrimaryGeneratorAction1* fAction1 = nullptr;
     PrimaryGeneratorAction2* fAction2 = nullptr;
     PrimaryGeneratorAction3* fAction3 = nullptr;
+    PrimaryGeneratorAction4* fAction4 = nullptr;
+    PrimaryGeneratorAction5* fAction5 = nullptr;
 
     G4int fSelectedAction = 1;
 
+    G4int fPrimariesPerEvent = 1;
+    G4int fNbPrimarySlots = 1;
+    std::vector<G4int> fPrimarySlots;   // rang du primaire de chaque particule primaire
+
     PrimaryGeneratorMessenger* fGunMessenger = nullptr;
 };
 #endif
@@ -4,12 +4,16 @@
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "globals.hh"
 #include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+#include "SpectrumSampler.hh"
 #include <vector>
 
 class G4ParticleGun;
 class G4Event;
 class DetectorConstruction;
 class G4VSolid;
+class G4ParticleDefinition;
+class VolumeSampler;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -25,6 +29,20 @@ class PrimaryGeneratorAction2
   public:
     G4double RejectAccept();
     G4double InverseCumul();
+
+    // Tirage de l'énergie : spectre tabulé tronqué à E > kEcut, table d'alias O(1)
+    G4double SampleEnergy() const;
+
+    // Spectre actif (/primariesgenerator/spectrum) : "builtin" ou un nom de SpectrumLibrary
+    void SelectSpectrum(const G4String& name);
+    const G4String& GetSpectrumName() const { return fSpectrumName; }
+
+    // Micro-benchmark (/primariesgenerator/benchmarkEnergy N) : tirages par seconde
+    // de l'ancien tirage (InverseCumul + rejet E <= kEcut) et de la table d'alias
+    void BenchmarkEnergySampling(G4int nSamples);
+
+    // Les énergies <= 3.5 keV ne sont jamais émises (intégré à la table d'alias)
+    static constexpr G4double kEcut = 3.5*CLHEP::keV;
     
     // =====================================================
     // NOUVEAU : Méthode pour générer une position aléatoire
@@ -36,8 +54,24 @@ class PrimaryGeneratorAction2
     void SetVolumeSourceMode(G4bool mode) { fUseVolumeSource = mode; }
     G4bool GetVolumeSourceMode() const { return fUseVolumeSource; }
 
+    // =====================================================
+    // Échantillonnage préférentiel de l'angle d'émission
+    //   (/primariesgenerator/angularBias, biasHalfAngle, biasFraction)
+    //
+    //  Mélange défensif : avec la probabilité p, cos(alpha) est tiré dans
+    //  le cône d'ouverture theta_b (ouverture du cône Compton vue de la
+    //  source), sinon dans le cône complet de 60°. Le poids du primaire
+    //  vaut pdf_analogue / pdf_biaisée, de sorte que les estimateurs
+    //  pondérés restent non biaisés.
+    // =====================================================
+    void SetAngularBias(G4bool on);
+    void SetBiasHalfAngle(G4double angle);
+    void SetBiasFraction(G4double p);
+    G4bool GetAngularBias() const { return fAngularBias; }
+
   private:
     G4ParticleGun*         fParticleGun = nullptr;
+    G4ParticleDefinition*  fGamma = nullptr;   // résolu au premier tirage
 
     G4int                  fNPoints = 0; //nb of points
     std::vector<G4double>  fX;           //abscisses X
@@ -45,9 +79,19 @@ class PrimaryGeneratorAction2
     std::vector<G4double>  fSlp;         //slopes
     std::vector<G4double>  fYC;          //cumulative function of Y
     G4double               fYmax = 0.;   //max(Y)
+    SpectrumSampler        fEnergySampler;  //alias sur les segments de ]kEcut, fX.back()]
+
+    // spectre tiré : fEnergySampler ("builtin") ou table partagée de SpectrumLibrary
+    const SpectrumSampler* fActiveSampler = nullptr;
+    G4String               fSpectrumName = "builtin";
 
     G4double fCosAlphaMin = 0., fCosAlphaMax = 0.;      //solid angle
     G4double fPsiMin = 0., fPsiMax = 0.;
+
+    // Échantillonnage préférentiel (désactivé par défaut : run analogue, poids 1)
+    G4bool   fAngularBias     = false;
+    G4double fCosBiasAperture = 0.;    // cos(theta_b), initialisé dans le constructeur
+    G4double fBiasFraction    = 0.5;   // p : part des tirages dans l'ouverture
     
     // =====================================================
     // NOUVEAU : Membres pour la source volumique
@@ -62,17 +106,26 @@ class PrimaryGeneratorAction2
     G4double fAnodeZmin = -0.001;
     G4double fAnodeZmax =  0.0;
     
-    // Pointeur vers le solide de l'anode (pour le test Inside())
+    // Pointeur vers le solide de l'anode
     G4VSolid* fAnodeSolid = nullptr;
+
+    // Voxels de l'anode ∩ fenêtre (partagés entre threads) : tirage O(1) sans Inside()
+    const VolumeSampler* fAnodeSampler = nullptr;
+    static constexpr G4double kAnodeVoxelSize = 10.*CLHEP::um;
     
-    // Flag pour initialisation
+    // Flag pour initialisation, et géométrie pour laquelle elle a été faite
     G4bool fAnodeInitialized = false;
+    G4int  fAnodeGeometryVersion = -1;
     
     // Méthode d'initialisation du volume source
     void InitializeAnodeVolume();
 
   private:
     void InitFunction();
+
+    // Tirage de cos(alpha) (analogue ou biaisé) et poids associé
+    G4double SampleCosAlpha(G4double& weight) const;
+    void PrintAngularBias() const;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,37 @@
+#ifndef PrimaryGeneratorAction4_h
+#define PrimaryGeneratorAction4_h
+
+#include "PhaseSpace.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Event;
+class G4ParticleDefinition;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Rejeu d'un espace des phases (voir PhaseSpace.hh) : chaque histoire lue est
+// rejouée /phasespace/reuse fois, poids divisé d'autant, chaque rejeu tourné
+// d'un angle azimutal aléatoire autour de z. Un vertex par particule et par
+// rejeu ; tous les rejeux d'une histoire sont émis par le même appel, donc
+// comptés comme UNE histoire statistique (ils sont corrélés).
+class PrimaryGeneratorAction4
+{
+  public:
+    PrimaryGeneratorAction4() = default;
+   ~PrimaryGeneratorAction4() = default ;
+
+  public:
+    void GeneratePrimaries(G4Event*);
+
+  private:
+    std::vector<PhaseSpace::Record> fHistory;   // histoire en cours de rejeu
+    std::vector<G4ParticleDefinition*> fParticles;   // particule de chaque enregistrement
+    G4bool fExhausted = false;                  // fichiers épuisés pendant ce run
+    G4int fRunID = -1;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef PrimaryGeneratorAction5_h
+#define PrimaryGeneratorAction5_h
+
+#include "globals.hh"
+
+class G4ParticleGun;
+class G4Event;
+class G4ParticleDefinition;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Source de tube paramétrée (voir TubeSourceModel.hh) : position tirée dans la
+// carte du foyer, couple (angle, énergie) dans la table d'effet talon.
+// Tables partagées et précalculées : aucune allocation ni recherche par primaire.
+class PrimaryGeneratorAction5
+{
+  public:
+    PrimaryGeneratorAction5(G4ParticleGun*);
+   ~PrimaryGeneratorAction5() = default;
+
+  public:
+    void GeneratePrimaries(G4Event*);
+
+  private:
+    G4ParticleGun*         fParticleGun = nullptr;
+    G4ParticleDefinition*  fGamma = nullptr;   // résolu au premier tirage
+    G4int fRunID = -1;                         // table manquante signalée une fois par run
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
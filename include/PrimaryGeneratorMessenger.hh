@@ -7,6 +7,10 @@
 class PrimaryGeneratorAction;
 class G4UIdirectory;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -23,6 +27,20 @@ class PrimaryGeneratorMessenger: public G4UImessenger
 
     G4UIdirectory*        fDirGenerator = nullptr;;
     G4UIcmdWithAnInteger* fSelectActionCmd = nullptr;
+
+    // échantillonnage préférentiel de l'angle d'émission (PrimaryGeneratorAction2)
+    G4UIcmdWithABool*          fAngularBiasCmd   = nullptr;
+    G4UIcmdWithADoubleAndUnit* fBiasHalfAngleCmd = nullptr;
+    G4UIcmdWithADouble*        fBiasFractionCmd  = nullptr;
+
+    // micro-benchmark du tirage de l'énergie (PrimaryGeneratorAction2)
+    G4UIcmdWithAnInteger*      fBenchmarkEnergyCmd = nullptr;
+
+    // spectre de la source 2 (SpectrumLibrary, "builtin" par défaut)
+    G4UIcmdWithAString*        fSpectrumCmd = nullptr;
+
+    // primaires indépendants par G4Event (scores tenus par primaire)
+    G4UIcmdWithAnInteger*      fPrimariesPerEventCmd = nullptr;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
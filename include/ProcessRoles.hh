@@ -0,0 +1,68 @@
+#ifndef PROCESSROLES_HH
+#define PROCESSROLES_HH
+
+#include "G4VProcess.hh"
+#include "globals.hh"
+
+// ============================================================================
+// ProcessRoles : identification des processus par (type, sous-type) entiers
+//
+//  - ProcessRoles::Build() est appelé en BeginOfRunAction sur CHAQUE thread :
+//    on y retrouve une fois, par leur nom, les processus utiles ("compt",
+//    "phot", "Transportation", "msc") dans le G4ProcessTable du thread et on
+//    mémorise leur clé (type, sous-type) ;
+//  - en cours de run, ProcessRoles::Of() ne lit que GetProcessType() /
+//    GetProcessSubType() (accesseurs inline) : aucune comparaison de chaînes.
+//  - les noms de processus ne servent plus qu'à l'affichage / aux bilans.
+//  - kNonPhysical : processus de monde parallèle (type fParallel, importance
+//    -i) et limiteur du biais générique (G4BiasingProcessInterface sans
+//    processus enveloppé, repéré en Build()) ; ils limitent le step sans
+//    interaction.
+// ============================================================================
+namespace ProcessRole
+{
+    enum Role : G4int {
+        kOther = 0,
+        kCompton,          // "compt"
+        kPhotoElectric,    // "phot"
+        kTransportation,   // "Transportation"
+        kMsc,              // "msc" (même clé pour toutes les particules)
+        kNonPhysical,      // monde parallèle, limiteur de biais sans processus
+        kNbRoles
+    };
+}
+
+class ProcessRoles
+{
+public:
+    // Résolution nom -> clé pour le thread courant (début de run)
+    static void Build();
+
+    static inline G4int Of(const G4VProcess* p) {
+        if (!p) return ProcessRole::kOther;
+        if (p->GetProcessType() == fParallel) return ProcessRole::kNonPhysical;
+        const G4int key = Key(p);
+        for (G4int r = 1; r < ProcessRole::kNbRoles; ++r) {
+            if (key == fKeys[r]) return r;
+        }
+        return ProcessRole::kOther;
+    }
+
+    // Vrai pour une interaction "physique" (ni transport, ni diffusion multiple,
+    // ni limiteur de step sans physique)
+    static inline G4bool IsPhysical(G4int role) {
+        return role != ProcessRole::kTransportation && role != ProcessRole::kMsc
+            && role != ProcessRole::kNonPhysical;
+    }
+
+    static const char* RoleName(G4int role);
+
+private:
+    static inline G4int Key(const G4VProcess* p) {
+        return 1000*static_cast<G4int>(p->GetProcessType()) + p->GetProcessSubType();
+    }
+
+    static G4ThreadLocal G4int fKeys[ProcessRole::kNbRoles];   // -1 = non trouvé
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef RANGEREJECTION_HH
+#define RANGEREJECTION_HH
+
+#include "G4Material.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <set>
+#include <string>
+#include <vector>
+
+class RangeRejectionMessenger;
+
+// ============================================================================
+// RangeRejection : arrêt des électrons qui ne peuvent pas atteindre un scoreur
+//
+//  Avec les cuts de 1 µm de ConstructGDML, chaque électron photo/Compton de
+//  l'anode, du laiton, de l'inox ou du graphite est transporté en pas très
+//  courts sans presque jamais atteindre un scoreur. À la fin de chaque step
+//  d'un e- créé par "phot" ou "compt" (jamais un électron du faisceau de la
+//  source 3 ni ses deltas, qui produisent le rayonnement de l'anode), dans un
+//  volume non scoreur, un matériau sélectionné, E <= maxEnergy, la
+//  portée R(E) dans le matériau courant (tables de G4LossTableManager,
+//  dE/dx restreint : R >= portée CSDA, donc conservateur) est comparée :
+//    1. à la safety isotrope du point post-step (distance au plus proche bord
+//       du volume courant) : R < safety -> l'électron ne quitte pas le volume ;
+//    2. sinon, à la distance au plus proche scoreur (boîtes englobantes
+//       globales des plans, couronnes, cube, sphère, plus le plan d'espace des
+//       phases et la boîte du maillage de dose s'ils sont actifs) : si R est
+//       plus petite ET que le volume voisin, de l'autre côté de la face la
+//       plus proche, est lui aussi d'un matériau sélectionné et assez épais,
+//       l'électron franchit une frontière interne (anode/laiton, laiton/inox...)
+//       sans pouvoir atteindre un scoreur. Seule la face la plus proche est
+//       sondée : un coin de volume reste une approximation.
+//  Un électron arrêté dépose son énergie sur place : tally par matériau dans
+//  RunAction et maillage de dose (/dosemesh/) au point d'arrêt. Les volumes
+//  scoreurs (couronnes d'eau, plans) ne sont jamais concernés : le dépôt
+//  d'énergie des couronnes reste celui du transport. Le rendement radiatif
+//  des électrons arrêtés (bremsstrahlung, fluorescence X après ionisation)
+//  est négligé (rendement de freinage ~0.4 % à 100 keV dans le tungstène,
+//  moins dans les matériaux plus légers et aux énergies plus basses).
+//
+//  Configuration (macro /rangeRejection/, fixée avant le run, partagée) :
+//    /rangeRejection/enable true|false
+//    /rangeRejection/addMaterial <nom>   /rangeRejection/removeMaterial <nom>
+//    /rangeRejection/maxEnergy <E> keV   /rangeRejection/list
+//  Matériaux par défaut : Tungsten, Brass, StainlessSteel304, G4_GRAPHITE.
+// ============================================================================
+class RangeRejection
+{
+public:
+    // Messenger /rangeRejection/ (master / SEQ uniquement, sans effet ailleurs)
+    static void Init();
+
+    // ----- Configuration (master, avant le run) -----
+    static void SetEnabled(G4bool on)        { fEnabled = on; }
+    static void SetMaxEnergy(G4double e)     { fMaxEnergy = e; }
+    static void AddMaterial(const G4String& name)    { fMaterialNames.insert(name); }
+    static void RemoveMaterial(const G4String& name) { fMaterialNames.erase(name); }
+    static void PrintMaterials();
+
+    static inline G4bool   IsEnabled()       { return fEnabled; }
+    static inline G4double GetMaxEnergy()    { return fMaxEnergy; }
+
+    // Matériau sélectionné (table indexée par G4Material::GetIndex())
+    static inline G4bool Applies(const G4Material* mat) {
+        if (!mat) return false;
+        const auto idx = mat->GetIndex();
+        return idx < fByIndex.size() && fByIndex[idx];
+    }
+
+    // Distance minimale (borne inférieure) de p aux scoreurs du run
+    static G4double DistanceToScorers(const G4ThreeVector& p);
+
+    // Début de run : noms -> table par index, boîtes des scoreurs (master,
+    // avant les workers), affichage
+    static void BeginRun();
+
+private:
+    static G4bool                fEnabled;
+    static G4double              fMaxEnergy;
+    static std::set<std::string> fMaterialNames;
+    static std::vector<G4bool>   fByIndex;
+
+    // Boîtes englobantes des scoreurs, repère global (coins min / max)
+    struct Box { G4ThreeVector min, max; };
+    static std::vector<Box>      fScorerBoxes;
+
+    static RangeRejectionMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef RangeRejectionMessenger_h
+#define RangeRejectionMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+class RangeRejectionMessenger : public G4UImessenger {
+public:
+    RangeRejectionMessenger();
+    virtual ~RangeRejectionMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithAString* fAddMaterialCmd;
+    G4UIcmdWithAString* fRemoveMaterialCmd;
+    G4UIcmdWithADoubleAndUnit* fMaxEnergyCmd;
+    G4UIcmdWithoutParameter* fListCmd;
+};
+
+#endif
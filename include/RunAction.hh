@@ -7,9 +7,15 @@
 #include "G4AnalysisManager.hh"
 #include "G4Accumulable.hh"
 #include "G4AccumulableManager.hh"
+#include "G4Timer.hh"
+
+#include "CounterMapAccumulable.hh"
+#include "DoseMesh.hh"
 
 #include <vector>
+#include <string>
 #include <map>
+#include <utility>
 #include <fstream>
 
 class G4Run;
@@ -17,6 +23,9 @@ class G4Event;
 class RunMessenger;
 class SphereHit;
 class EventAction;
+class G4Material;
+class G4VProcess;
+class G4LogicalVolume;
 
 class RunAction : public G4UserRunAction
 {
@@ -75,6 +84,9 @@ class RunAction : public G4UserRunAction
         // Ajouter l'énergie déposée d'un événement
         void AddEdepFromEvent(const G4double* edepRing, G4double edepTotal);
         
+        // Kerma des anneaux (estimateur par longueur de trace des photons) d'un événement
+        void AddKermaFromEvent(const G4double* kermaRing);
+
         // Accesseurs pour les énergies accumulées
         G4double GetTotalEdepRing(G4int ringIndex) const;
         G4double GetTotalEdepWater() const;
@@ -82,12 +94,57 @@ class RunAction : public G4UserRunAction
         // Pour les histogrammes par 10000 événements
         void CheckAndFillDoseHistograms(G4int eventID);
         
-        // Compteur de photons transmis (mis à jour depuis SurfaceSpectrumSD)
-        void AddTransmittedPhoton() { fTransmitted10000++; fTransmittedTotal++; }
-        G4long GetTransmittedTotal() const { return fTransmittedTotal; }
+        // Compteur de photons transmis (mis à jour depuis SurfaceSpectrumSD) :
+        // nombre brut et somme des poids, par primaire de l'événement courant
+        void AddTransmittedPhoton(G4double weight = 1., G4int slot = 0) {
+            fTransmitted10000++; fTransmittedTotal += 1;
+            if (slot >= static_cast<G4int>(fTransmittedWeightEvent.size())) fTransmittedWeightEvent.resize(slot + 1, 0.);
+            fTransmittedWeightEvent[slot] += weight;
+        }
+        G4long GetTransmittedTotal() const { return fTransmittedTotal.GetValue(); }
+
+        // Fin d'événement : scores pondérés de transmission (un par primaire) -> S et S2 du run
+        void FlushEventTransmission();
+
+        // ==================== Compteurs côté Stepping (par thread, fusionnés en fin de run) ====================
+        // Remplacent les anciens globaux gEnterPlanePrim / gLeavePlanePrim / gLostByProc / gLostByMat
+        void AddEnterPlanePrim() { fEnterPlanePrim += 1; }
+        void AddLeavePlanePrim() { fLeavePlanePrim += 1; }
+        // [FIX] Clés pointeurs pendant le run (pas de copie de chaînes par primaire perdu) ;
+        //       les noms sont résolus une fois en fin de run (FlushLostPrimaries)
+        void AddLostPrimary(const G4Material* mat, const G4VProcess* proc) {
+            ++fLostByMatPtr[mat];
+            ++fLostByProcPtr[proc];
+        }
+        // Électrons arrêtés par RangeRejection, par matériau (énergie pondérée, keV)
+        void AddRangeRejected(const G4Material* mat, G4double weightedEkin) {
+            auto& entry = fRangeRejectedByMatPtr[mat];
+            ++entry.first;
+            entry.second += weightedEkin;
+        }
+        // Tracks arrêtés par TrackKiller, par volume quitté (énergie cinétique pondérée)
+        void AddKilledTrack(const G4LogicalVolume* lv, G4double weightedEkin) {
+            auto& entry = fKilledByVolPtr[lv];
+            ++entry.first;
+            entry.second += weightedEkin;
+        }
+
+        // Maillage 3D de dose (/dosemesh/), rempli par DoseMeshObserver, vidé par événement
+        DoseMesh& GetDoseMesh() { return fDoseMesh; }
+
+        // Taille d'un lot pour les histogrammes H4 / H10-H14
+        static constexpr G4int kEventsPerDoseBatch = 10000;
 
     private:
 
+        // Enregistrement des accumulables : même ordre sur le master et sur chaque worker
+        void RegisterAccumulables();
+
+        // Conversion pointeurs -> noms des pertes de primaires (avant Merge())
+        void FlushLostPrimaries();
+        // Idem pour les tracks arrêtés par TrackKiller et RangeRejection
+        void FlushKilledTracks();
+
         mutable G4Accumulable<G4int> fNValidParticles_lt_35;
         mutable G4Accumulable<G4int> fNValidParticles_gt_35;
 
@@ -109,17 +166,57 @@ class RunAction : public G4UserRunAction
         mutable G4Accumulable<G4long> fPrimariesGenerated;
 
         // ==================== Accumulation des énergies déposées ====================
-        G4double fTotalEdepRing[kNbWaterRings] = {0., 0., 0., 0., 0.};
-        G4double fTotalEdepWater = 0.;
+        // Accumulables : chaque thread somme ses événements, Merge() donne le total du run
+        G4Accumulable<G4double> fTotalEdepRing[kNbWaterRings];
+        G4Accumulable<G4double> fTotalEdepWater;
+
+        // Sommes des CARRÉS des scores d'événement (énergies pondérées) :
+        // variance de la moyenne par histoire en fin de run
+        G4Accumulable<G4double> fTotalEdepRing2[kNbWaterRings];
+        G4Accumulable<G4double> fTotalEdepWater2;
         
-        // Pour les histogrammes par 10000 événements
+        // Pour les histogrammes par lot de 10000 événements : tampon PROPRE AU THREAD
+        // (un lot = 10000 événements traités par ce thread, les H1 sont fusionnés par G4AnalysisManager)
         G4double fEdepRing10000[kNbWaterRings] = {0., 0., 0., 0., 0.};
         G4double fEdepWater10000 = 0.;
-        G4int fLastHistoFillEvent = -10000;  // pour suivre quand on a rempli les histos
+        G4int fEventsInBatch = 0;
+
+        // Kerma par longueur de trace des photons (keV, pondéré) : sommes S et S2 du run,
+        // tampon du lot de 10000 événements (par thread)
+        G4Accumulable<G4double> fTotalKermaRing[kNbWaterRings];
+        G4Accumulable<G4double> fTotalKermaRing2[kNbWaterRings];
+        G4double fKermaRing10000[kNbWaterRings] = {0., 0., 0., 0., 0.};
         
-        // Compteur de photons transmis par lot de 10000 événements
+        // Compteur de photons transmis par lot de 10000 événements (par thread) et sur le run
         G4long fTransmitted10000 = 0;
-        G4long fTransmittedTotal = 0;
+        G4Accumulable<G4long> fTransmittedTotal;
+
+        // Transmission pondérée : poids par primaire de l'événement courant (par thread), S et S2 du run
+        std::vector<G4double> fTransmittedWeightEvent;
+        G4Accumulable<G4double> fTransmittedW;
+        G4Accumulable<G4double> fTransmittedW2;
+
+        // Compteurs côté Stepping
+        G4Accumulable<G4long> fEnterPlanePrim;
+        G4Accumulable<G4long> fLeavePlanePrim;
+        CounterMapAccumulable fLostByProc{"LostByProc"};
+        CounterMapAccumulable fLostByMat{"LostByMat"};
+        std::map<const G4Material*, G4long> fLostByMatPtr;    // par thread, vidé en fin de run
+        std::map<const G4VProcess*, G4long> fLostByProcPtr;   // par thread, vidé en fin de run
+
+        // Arrêt géométrique (TrackKiller) : nombre et énergie (keV) par volume quitté
+        CounterMapAccumulable fKilledByVol{"KilledByVol"};
+        std::map<const G4LogicalVolume*, std::pair<G4long, G4double>> fKilledByVolPtr;   // par thread
+
+        // Rejet par la portée (RangeRejection) : nombre et énergie déposée (keV) par matériau
+        CounterMapAccumulable fRangeRejectedByMat{"RangeRejectedByMat"};
+        std::map<const G4Material*, std::pair<G4long, G4double>> fRangeRejectedByMatPtr;   // par thread
+
+        // Maillage 3D de dose : blocs alloués au premier dépôt, fusionnés sur le master
+        DoseMesh fDoseMesh{"DoseMesh"};
+
+        // Chrono du run (débit en événements/s affiché en fin de run)
+        G4Timer fRunTimer;
 
 };
 #endif
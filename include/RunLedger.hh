@@ -0,0 +1,119 @@
+#ifndef RUNLEDGER_HH
+#define RUNLEDGER_HH
+
+#include "G4VAccumulable.hh"
+#include "G4Version.hh"
+#include "globals.hh"
+
+#include <array>
+
+// ============================================================================
+// RunLedger : registre de compteurs "sans verrou" pour la boucle d'événements
+//
+//  - une instance PAR THREAD (RunLedger::Instance() est G4ThreadLocal) ;
+//  - chaque compteur est un slot d'un tableau dense, indexé par Ledger::Slot ;
+//  - l'instance est enregistrée dans le G4AccumulableManager du thread par
+//    RunAction::RegisterAccumulables() : Reset() en BeginOfRunAction,
+//    Merge() (somme des workers dans le master) en EndOfRunAction.
+//
+//  Remplace les globaux protégés par mutex et les "static int dbg" locaux
+//  aux fonctions de SteppingAction, SurfaceSpectrumSD et ScorePlaneNSD.
+//  Les compteurs de logs (throttling "les N premiers") sont donc par thread.
+// ============================================================================
+namespace Ledger
+{
+    // Champs d'un plan de comptage ScorePlaneNSD (slot = base du plan + champ)
+    enum PlaneField : G4int {
+        kPlaneTotal = 0,      // appels ProcessHits
+        kPlaneAccepted,       // passages acceptés (direction +Z)
+        kPlaneRejected,       // passages rejetés (direction -Z ou latérale)
+        kPlaneLogInit,        // logs Initialize
+        kPlaneLogReject,      // logs REJECT
+        kPlaneLogWrite,       // logs WROTE row
+        kPlaneLogEnd,         // logs EndOfEvent
+        kNbPlaneFields
+    };
+
+    enum Slot : G4int {
+        // ----- SteppingAction -----
+        kComptonInCone = 0,   // diffusions Compton de primaires dans logicConeCompton
+        kAbsGraphite,         // absorptions photoélectriques de primaires dans le cône
+        kAbsInox,             // absorptions photoélectriques de primaires dans l'inox
+        kLogTracePlane,       // logs [TRACE][PLANE ENTER/LEAVE]
+        kLogTraceZ60,         // logs [TRACE][Z=60]
+        kLogStepEnter,        // logs [STEP][ENTER][prim]
+        kLogStepLeave,        // logs [STEP][LEAVE][prim]
+        kKillBackward,        // tracks arrêtés par TrackKiller, règle backward
+        kKillSide,            // idem, règle side
+        kKillBeyond,          // idem, règle beyond
+        kRangeRejected,       // e- arrêtés par RangeRejection (dépôt local)
+        kPhaseSpaceWritten,   // particules écrites au plan de l'espace des phases
+        kPhaseSpaceDropped,   // particules d'un type non enregistré, arrêtées au plan
+        kPhaseSpaceUpstream,  // rejeu : particules arrêtées en repassant le plan vers -z
+
+        // ----- TrackingAction -----
+        kTracks,              // tracks transportés (coût moyen d'un track)
+
+        // ----- EventAction -----
+        kTrajectoriesStored,  // trajectoires stockées (conteneur de l'événement)
+        kHistories,           // histoires (primaires) : événements x primaires par événement
+
+        // ----- SurfaceSpectrumSD (SpecSD) -----
+        kSpecEnter,           // pas entrant dans le plan
+        kSpecLeave,           // pas sortant du plan
+        kSpecOut,             // sous-ensemble leave "outward"
+        kSpecRows,            // lignes écrites dans plane_passages
+        kSpecPrimaryEvents,   // événements avec au moins une ligne primaire
+        kSpecComptonRedirected, // primaires Compton-cône atteignant le plan
+        kSpecSecondaries,     // secondaires atteignant le plan
+        kSpecLogCalls,        // logs ProcessHits
+        kSpecLogRejectLeave,  // logs "skip (not leaving)"
+        kSpecLogRejectInward, // logs "REJECT (inward/side)"
+        kSpecLogFill,         // logs [plane_passages][fill#]
+        kSpecLogInactive,     // logs "Analysis manager inactive"
+
+        // ----- ScorePlaneNSD (N = 2, 3, 4 = couronnes d'eau, 5) -----
+        kScorePlane2Base,
+        kScorePlane3Base = kScorePlane2Base + kNbPlaneFields,
+        kScorePlane4Base = kScorePlane3Base + kNbPlaneFields,
+        kScorePlane5Base = kScorePlane4Base + kNbPlaneFields,
+
+        kNbSlots = kScorePlane5Base + kNbPlaneFields
+    };
+
+    inline constexpr G4int PlaneSlot(G4int base, PlaneField field) { return base + field; }
+}
+
+class RunLedger : public G4VAccumulable
+{
+public:
+    // Instance du thread courant (créée à la première demande)
+    static RunLedger* Instance();
+
+    // Incrémente un slot et renvoie la valeur AVANT incrément
+    // (pratique pour "n'imprimer que les N premiers").
+    inline G4long Add(G4int slot, G4long n = 1) {
+        const G4long before = fCounts[slot];
+        fCounts[slot] = before + n;
+        return before;
+    }
+    inline G4long Get(G4int slot) const { return fCounts[slot]; }
+
+    // Bilan (sur le master après Merge() en MT, ou en SEQ)
+    void PrintSummary() const;
+    void PrintPlaneSummary(const char* sdName, G4int base) const;
+
+    // Interface G4VAccumulable
+    void Merge(const G4VAccumulable& other) override;
+    void Reset() override;
+#if G4VERSION_NUMBER >= 1130
+    void Print(G4PrintOptions options = G4PrintOptions()) const override;
+#endif
+
+private:
+    explicit RunLedger(const G4String& name) : G4VAccumulable(name) { fCounts.fill(0); }
+
+    std::array<G4long, Ledger::kNbSlots> fCounts;
+};
+
+#endif
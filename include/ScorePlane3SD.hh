@@ -5,6 +5,7 @@
 #include "globals.hh"
 #include <set>
 
+class RunLedger;
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
@@ -44,10 +45,9 @@ public:
 private:
     G4int fNtupleId = -1;  // ID du ntuple dans G4AnalysisManager
 
-    // Compteurs pour debug/statistiques
-    G4long fCntTotal = 0;      // total de passages détectés
-    G4long fCntAccepted = 0;   // passages acceptés (direction +Z)
-    G4long fCntRejected = 0;   // passages rejetés (direction -Z ou latérale)
+    // [FIX] Compteurs total/accepted/rejected et logs : slots du RunLedger du thread
+    //       (base Ledger::kScorePlane3Base, fusionnés en fin de run)
+    RunLedger* fLedger = nullptr;
     
     // Pour éviter de compter plusieurs fois la même particule dans le même événement
     std::set<G4int> fTracksThisEvent;  // TrackID des particules déjà comptées
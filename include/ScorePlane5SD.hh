@@ -5,6 +5,7 @@
 #include "globals.hh"
 #include <set>
 
+class RunLedger;
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
@@ -33,9 +34,9 @@ public:
 private:
     G4int fNtupleId = -1;
 
-    G4long fCntTotal = 0;
-    G4long fCntAccepted = 0;
-    G4long fCntRejected = 0;
+    // [FIX] Compteurs total/accepted/rejected et logs : slots du RunLedger du thread
+    //       (base Ledger::kScorePlane5Base, fusionnés en fin de run)
+    RunLedger* fLedger = nullptr;
     
     std::set<G4int> fTracksThisEvent;
 };
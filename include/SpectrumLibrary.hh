@@ -0,0 +1,62 @@
+#ifndef SPECTRUMLIBRARY_HH
+#define SPECTRUMLIBRARY_HH
+
+#include "SpectrumSampler.hh"
+#include "globals.hh"
+
+#include <map>
+#include <memory>
+#include <string>
+
+class SpectrumLibraryMessenger;
+
+// ============================================================================
+// SpectrumLibrary : spectres de tube tabulés lus dans des fichiers .dat
+//
+//  Au démarrage (master / SEQ, avant les workers), tous les fichiers
+//  spectrum_<nom>.dat du répertoire courant sont chargés (CMake les copie
+//  dans le répertoire de build) ; /spectra/load <fichier> en ajoute d'autres
+//  entre deux runs. Les tables de tirage (SpectrumSampler, tronquées à
+//  E > PrimaryGeneratorAction2::kEcut) sont construites UNE fois au
+//  chargement, puis seulement lues par les workers : aucune copie par thread.
+//  Une entrée n'est jamais remplacée ni détruite (les workers gardent un
+//  pointeur) : recharger un nom existant est refusé.
+//
+//  Format (une ligne par point, densité linéaire entre deux points) :
+//    # commentaire libre
+//    # kVp: 50
+//    # filter: 0.1 mm Al
+//    <E en keV>  <intensité>
+//
+//  Choix du spectre de la source 2 : /primariesgenerator/spectrum <nom>
+//  ("builtin" = table historique codée dans PrimaryGeneratorAction2).
+// ============================================================================
+class SpectrumLibrary
+{
+public:
+    struct Entry {
+        G4String        name;
+        G4String        file;
+        G4double        kVp = 0.;          // 0 si non renseigné
+        G4String        filter;
+        SpectrumSampler sampler;
+        std::size_t     nPoints = 0;
+    };
+
+    // Messenger /spectra/ et chargement des spectrum_*.dat (master / SEQ uniquement)
+    static void Init();
+
+    // Chargement d'un fichier ; nom = fichier sans "spectrum_" ni ".dat"
+    static G4bool Load(const G4String& file);
+
+    // Entrée d'un nom (nullptr si inconnu) ; appelé par les workers au changement de spectre
+    static const Entry* Find(const G4String& name);
+
+    static void Print();
+
+private:
+    static std::map<std::string, std::unique_ptr<Entry>> fEntries;
+    static SpectrumLibraryMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef SpectrumLibraryMessenger_h
+#define SpectrumLibraryMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+class SpectrumLibraryMessenger : public G4UImessenger {
+public:
+    SpectrumLibraryMessenger();
+    virtual ~SpectrumLibraryMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithAString* fLoadCmd;
+    G4UIcmdWithoutParameter* fListCmd;
+};
+
+#endif
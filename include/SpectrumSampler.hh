@@ -0,0 +1,50 @@
+#ifndef SPECTRUMSAMPLER_HH
+#define SPECTRUMSAMPLER_HH
+
+#include "AliasTable.hh"
+#include "globals.hh"
+
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+// ============================================================================
+// SpectrumSampler : tirage en O(1) d'une densité linéaire par morceaux
+//
+//  Densité tabulée (x croissants, y >= 0, linéaire entre deux points) et
+//  restreinte à ]xMin, xMax] : le segment coupé est raccourci et son y
+//  interpolé, la troncature est donc exacte et sans rejet.
+//    1) segment choisi par une table d'alias (poids = aire du trapèze) ;
+//    2) position dans le segment par inversion analytique de la cumulée
+//       (densité linéaire), sous une forme stable même si y0 = y1 ou y0 = 0.
+//  Deux nombres aléatoires par tirage, sans recherche ni boucle.
+//  Construit une fois, puis lu seul.
+// ============================================================================
+class SpectrumSampler
+{
+public:
+    void Build(const std::vector<G4double>& x, const std::vector<G4double>& y,
+               G4double xMin = -DBL_MAX, G4double xMax = DBL_MAX);
+
+    inline G4bool   Empty() const    { return fAlias.Empty(); }
+    inline G4double Integral() const { return fIntegral; }   // aire de la densité tronquée
+    G4double Mean() const;                                   // moyenne exacte de la densité tronquée
+
+    // u1, u2 uniformes dans [0,1[
+    inline G4double Sample(G4double u1, G4double u2) const {
+        const std::size_t i = fAlias.Sample(u1);
+        const G4double y0 = fY0[i], y1 = fY1[i];
+        // F(t) = (y0 t + (y1-y0) t^2 / 2) / ((y0+y1)/2) = u2, t dans [0,1]
+        const G4double den = y0 + std::sqrt(y0*y0 + (y1*y1 - y0*y0)*u2);
+        const G4double t = (den > 0.) ? u2*(y0 + y1)/den : 0.;
+        return fX0[i] + t*fWidth[i];
+    }
+
+private:
+    // Segments de probabilité non nulle
+    std::vector<G4double> fX0, fWidth, fY0, fY1;
+    AliasTable fAlias;
+    G4double   fIntegral = 0.;
+};
+
+#endif
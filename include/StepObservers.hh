@@ -0,0 +1,296 @@
+#ifndef STEPOBSERVERS_HH
+#define STEPOBSERVERS_HH
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "globals.hh"
+
+#include "VolumeRoles.hh"
+
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+class EventAction;
+class RunAction;
+class RunLedger;
+class DoseMesh;
+class MyTrackInfo;
+class G4ParticleDefinition;
+class G4Navigator;
+
+// ============================================================================
+// Observateurs de step par volume
+//
+//  Chaque "sujet d'analyse" de SteppingAction (fenêtre Be, couronnes d'eau,
+//  Compton dans le cône, plan de comptage, pertes de primaires, cube d'eau...)
+//  est un StepObserver enregistré auprès du StepObserverRegistry pour le ou
+//  les RÔLES de volume qui l'intéressent (VolumeRole, cf. VolumeRoles.hh).
+//
+//  À chaque step, SteppingAction n'appelle que les observateurs attachés au
+//  rôle du volume pre-step ou post-step : un step dans le vide du tube ou
+//  l'air de l'enveloppe ne déclenche que les observateurs "toujours actifs".
+// ============================================================================
+
+// Informations du step résolues une fois par SteppingAction
+struct StepContext
+{
+    const G4Step*       step;
+    G4Track*            track;
+    const G4StepPoint*  pre;
+    const G4StepPoint*  post;
+    const VolumeInfo&   preInfo;
+    const VolumeInfo&   postInfo;
+    G4int               procRole;    // ProcessRole::Role du processus du step
+    G4int               eventID;
+    MyTrackInfo*        trackInfo;   // jamais nul (créé par SteppingAction)
+};
+
+class StepObserver
+{
+public:
+    explicit StepObserver(const char* name) : fName(name) {}
+    virtual ~StepObserver() = default;
+
+    virtual void OnStep(const StepContext& ctx) = 0;
+
+    const char* GetName() const { return fName; }
+
+private:
+    friend class StepObserverRegistry;
+    const char* fName;
+    G4int fRoleMask = 0;   // bits (1 << VolumeRole) où l'observateur est attaché
+};
+
+class StepObserverRegistry
+{
+public:
+    // Le registre devient propriétaire de l'observateur.
+    // roles vide => observateur appelé à chaque step.
+    StepObserver* Register(StepObserver* obs, std::initializer_list<G4int> roles);
+    void Clear();
+
+    // Appelle les observateurs du rôle pre-step, puis ceux du rôle post-step
+    // (un observateur attaché aux deux rôles n'est appelé qu'une fois), puis
+    // les observateurs "toujours actifs" (qui voient donc un éventuel
+    // fStopAndKill posé par un observateur de volume, ex. WaterCube).
+    inline void Dispatch(const StepContext& ctx) const {
+        const G4int preRole  = ctx.preInfo.role;
+        const G4int postRole = ctx.postInfo.role;
+        for (auto* obs : fByRole[preRole]) obs->OnStep(ctx);
+        if (postRole != preRole) {
+            for (auto* obs : fByRole[postRole]) {
+                if (!(obs->fRoleMask & (1 << preRole))) obs->OnStep(ctx);
+            }
+        }
+        for (auto* obs : fAlways) obs->OnStep(ctx);
+    }
+
+    void Print() const;
+
+private:
+    std::vector<StepObserver*> fAlways;
+    std::vector<StepObserver*> fByRole[VolumeRole::kNbRoles];
+    std::vector<std::unique_ptr<StepObserver>> fOwned;
+};
+
+// ============================================================================
+// Observateurs concrets (un par sujet d'analyse)
+// ============================================================================
+
+// Fenêtre Be : entrées et interactions (compteurs EventAction)
+class BeWindowObserver : public StepObserver
+{
+public:
+    BeWindowObserver(EventAction* ev, G4int verbose)
+    : StepObserver("BeWindow"), fEventAction(ev), fVerbose(verbose) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    EventAction* fEventAction;
+    G4int fVerbose;
+};
+
+// Couronnes d'eau : dépôt d'énergie du volume PRE-step
+class WaterRingObserver : public StepObserver
+{
+public:
+    WaterRingObserver(EventAction* ev, G4int verbose)
+    : StepObserver("WaterRing"), fEventAction(ev), fVerbose(verbose) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    EventAction* fEventAction;
+    G4int fVerbose;
+};
+
+// Couronnes d'eau : kerma par longueur de trace des photons (L x mu_en/rho x E)
+class WaterRingKermaObserver : public StepObserver
+{
+public:
+    explicit WaterRingKermaObserver(EventAction* ev);
+    void OnStep(const StepContext& ctx) override;
+private:
+    EventAction* fEventAction;
+    const G4ParticleDefinition* fGamma;
+};
+
+// Cône graphite : marquage Compton des primaires + ntuple compton_cone_events
+class ComptonConeObserver : public StepObserver
+{
+public:
+    explicit ComptonConeObserver(RunLedger* ledger)
+    : StepObserver("ComptonCone"), fLedger(ledger) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    RunLedger* fLedger;
+};
+
+// Cône graphite, biais forced collision (option -f) : le clone créé à
+// l'entrée du cône hérite du MyTrackInfo du photon cloné (même lignée)
+class BiasCloneObserver : public StepObserver
+{
+public:
+    BiasCloneObserver() : StepObserver("BiasClone") {}
+    void OnStep(const StepContext& ctx) override;
+};
+
+// Plan de comptage : entrées/sorties des primaires (+ trace limitée)
+class ScorePlaneObserver : public StepObserver
+{
+public:
+    ScorePlaneObserver(RunAction* run, RunLedger* ledger, G4int verbose)
+    : StepObserver("ScorePlane"), fRunAction(run), fLedger(ledger), fVerbose(verbose) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    RunAction* fRunAction;
+    RunLedger* fLedger;
+    G4int fVerbose;
+};
+
+// Fin de piste des primaires : état final MyTrackInfo, pertes avant z=60 mm,
+// absorptions photoélectriques (abs_graphite / abs_inox)
+class PrimaryEndObserver : public StepObserver
+{
+public:
+    PrimaryEndObserver(EventAction* ev, RunAction* run, RunLedger* ledger, G4int verbose)
+    : StepObserver("PrimaryEnd"), fEventAction(ev), fRunAction(run), fLedger(ledger), fVerbose(verbose) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    EventAction* fEventAction;
+    RunAction* fRunAction;
+    RunLedger* fLedger;
+    G4int fVerbose;
+};
+
+// Espace des phases (PhaseSpace, /phasespace/) : écriture et arrêt au plan
+// (étape 1), arrêt des retours vers l'amont du plan pendant le rejeu (étape 2)
+class PhaseSpaceObserver : public StepObserver
+{
+public:
+    explicit PhaseSpaceObserver(RunLedger* ledger)
+    : StepObserver("PhaseSpace"), fLedger(ledger) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    RunLedger* fLedger;
+};
+
+// Arrêt géométrique (TrackKiller, /killer/) : aux frontières, tracks qui ne
+// peuvent plus atteindre un scoreur ; tally par volume quitté
+class TrackKillObserver : public StepObserver
+{
+public:
+    TrackKillObserver(RunAction* run, RunLedger* ledger);
+    void OnStep(const StepContext& ctx) override;
+private:
+    RunAction* fRunAction;
+    RunLedger* fLedger;
+    const G4ParticleDefinition* fGamma;
+    const G4ParticleDefinition* fElectron;
+    const G4ParticleDefinition* fPositron;
+};
+
+// Rejet par la portée (RangeRejection, /rangeRejection/) : e- qui ne peuvent
+// pas quitter leur volume, dépôt local tallyé par matériau
+class RangeRejectionObserver : public StepObserver
+{
+public:
+    RangeRejectionObserver(RunAction* run, RunLedger* ledger);
+    ~RangeRejectionObserver() override;
+    void OnStep(const StepContext& ctx) override;
+private:
+    // Volume voisin (face la plus proche) d'un matériau sélectionné, et assez
+    // épais pour contenir le reste du parcours ?
+    G4bool NeighbourContains(const G4StepPoint* post, G4double safety, G4double range);
+
+    RunAction* fRunAction;
+    RunLedger* fLedger;
+    const G4ParticleDefinition* fElectron;
+    std::unique_ptr<G4Navigator> fProbe;   // navigateur privé (ne touche pas au tracking)
+};
+
+// Maillage 3D de dose (DoseMesh, /dosemesh/) : dépôt de chaque step dans la
+// boîte, en un point uniforme du step (chargées) ou au post-step (neutres)
+class DoseMeshObserver : public StepObserver
+{
+public:
+    explicit DoseMeshObserver(RunAction* run);
+    void OnStep(const StepContext& ctx) override;
+private:
+    DoseMesh* fMesh;
+};
+
+// Cube d'eau : marquage d'entrée, arrêt des particules qui en sortent
+class WaterCubeObserver : public StepObserver
+{
+public:
+    explicit WaterCubeObserver(G4int verbose)
+    : StepObserver("WaterCube"), fVerbose(verbose) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    G4int fVerbose;
+};
+
+// Sphère d'eau : entrées et interactions (compteurs EventAction)
+class WaterSphereObserver : public StepObserver
+{
+public:
+    WaterSphereObserver(EventAction* ev, G4int verbose)
+    : StepObserver("WaterSphere"), fEventAction(ev), fVerbose(verbose) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    EventAction* fEventAction;
+    G4int fVerbose;
+};
+
+// ----- Diagnostics (enregistrés seulement si /stepping/verbose > 0) -----
+
+// Sortie de l'enveloppe GDML (logs)
+class EnveloppeExitObserver : public StepObserver
+{
+public:
+    EnveloppeExitObserver() : StepObserver("EnveloppeExit") {}
+    void OnStep(const StepContext& ctx) override;
+};
+
+// Croisement du plan z = 60 mm par les primaires (trace limitée)
+class Z60TraceObserver : public StepObserver
+{
+public:
+    explicit Z60TraceObserver(RunLedger* ledger)
+    : StepObserver("Z60Trace"), fLedger(ledger) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    RunLedger* fLedger;
+};
+
+// Logs génériques de chaque step (volumes, matériaux, positions)
+class VerboseStepObserver : public StepObserver
+{
+public:
+    explicit VerboseStepObserver(G4int verbose)
+    : StepObserver("VerboseStep"), fVerbose(verbose) {}
+    void OnStep(const StepContext& ctx) override;
+private:
+    G4int fVerbose;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef STEPTRACER_HH
+#define STEPTRACER_HH
+
+#include "G4Step.hh"
+#include "globals.hh"
+
+#include <atomic>
+#include <functional>
+
+class G4Event;
+class MyTrackInfo;
+class StepTracerMessenger;
+
+// ============================================================================
+// StepTracer : suivi step par step d'un ÉCHANTILLON d'événements
+//
+//  - la décision "cet événement est-il suivi ?" est prise UNE fois, dans
+//    EventAction::BeginOfEventAction (BeginEvent) ;
+//  - les tracks de l'événement suivi sont marquées dans leur MyTrackInfo
+//    (IsTraced) à leur création : plus de std::set d'eventID / de trackID ;
+//  - SteppingAction ne teste qu'un booléen par step (IsActive) ;
+//  - une fois le budget épuisé (tous threads), BeginEvent sort sur un
+//    booléen du thread : le suivi ne coûte plus rien.
+//
+//  Échantillon (macro /tracer/, fixé avant le run, partagé par les threads) :
+//    /tracer/maxEvents N    nombre d'événements suivis sur le run (0 = aucun)
+//    /tracer/every N        un événement sur N (eventID % N == 0)
+//    /tracer/eMin, eMax     fenêtre sur l'énergie cinétique du primaire
+//  et, côté code, SetFilter() pour un critère quelconque sur le G4Event.
+// ============================================================================
+class StepTracer
+{
+public:
+    using EventFilter = std::function<G4bool(const G4Event*)>;
+
+    // Instance du thread courant (le messenger /tracer/ est créé par le master)
+    static StepTracer* Instance();
+
+    // ----- Configuration (master, avant le run) -----
+    static void SetMaxEvents(G4int n)      { fMaxEvents = n; }
+    static void SetEvery(G4int n)          { fEvery = (n > 0) ? n : 1; }
+    static void SetEMin(G4double e)        { fEMin = e; }
+    static void SetEMax(G4double e)        { fEMax = e; }
+    static void SetFilter(EventFilter f)   { fFilter = std::move(f); }
+
+    static G4int GetMaxEvents()            { return fMaxEvents; }
+    static G4int GetTracedCount();
+
+    // Début de run : budget remis à zéro et en-tête (master/SEQ), état du thread
+    static void BeginRun();
+
+    // Décision pour l'événement courant (EventAction::BeginOfEventAction)
+    void BeginEvent(const G4Event* event);
+
+    inline G4bool IsActive() const { return fActive; }
+
+    // Ligne du tableau pour un step d'une track suivie
+    void PrintStep(const G4Step* step, G4int eventID) const;
+
+private:
+    StepTracer() = default;
+
+    G4bool Accepts(const G4Event* event) const;
+
+    // État du thread
+    G4bool fActive    = false;   // événement courant suivi
+    G4bool fExhausted = false;   // budget épuisé vu par ce thread (jusqu'au run suivant)
+
+    // Configuration partagée (écrite par le master hors run)
+    static G4int       fMaxEvents;
+    static G4int       fEvery;
+    static G4double    fEMin;
+    static G4double    fEMax;
+    static EventFilter fFilter;
+
+    // Budget global (tous threads) : réservation atomique, sans verrou
+    static std::atomic<G4int> fTracedCount;
+
+    static StepTracerMessenger* fMessenger;
+};
+
+#endif
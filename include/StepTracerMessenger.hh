@@ -0,0 +1,26 @@
+#ifndef StepTracerMessenger_h
+#define StepTracerMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+class StepTracerMessenger : public G4UImessenger {
+public:
+    StepTracerMessenger();
+    virtual ~StepTracerMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithAnInteger* fMaxEventsCmd;
+    G4UIcmdWithAnInteger* fEveryCmd;
+    G4UIcmdWithADoubleAndUnit* fEMinCmd;
+    G4UIcmdWithADoubleAndUnit* fEMaxCmd;
+};
+
+#endif
@@ -3,44 +3,40 @@
 
 #include "G4UserSteppingAction.hh"
 #include "G4Step.hh"
-#include <set>
 
 #include "DetectorConstruction.hh"
 #include "EventAction.hh"
 
 #include "SteppingMessenger.hh"
+#include "StepObservers.hh"
 #include "globals.hh"
 
+class RunAction;
+class RunLedger;
+class StepTracer;
+
 class SteppingAction : public G4UserSteppingAction
 {
 public:
-    SteppingAction(EventAction* eventAction);
+    SteppingAction(EventAction* eventAction, RunAction* runAction);
     ~SteppingAction();
 
     virtual void UserSteppingAction(const G4Step*);
-    void SetVerbose(G4int level){fSteppingVerboseLevel = level;};
-
-    // ==================== Step Tracking (print to output) ====================
-    static void ResetTrackedParticlesCount();
-    static G4int GetTrackedParticlesCount();
-    static void SetMaxTrackedParticles(G4int n);
-    static G4int GetMaxTrackedParticles();
+    void SetVerbose(G4int level);   // reconstruit aussi le registre d'observateurs
+    void BeginRun();                // idem, avec la configuration figée du run
 
 private:
     EventAction *fEventAction;
+    RunAction   *fRunAction = nullptr;   // RunAction du MÊME thread (compteurs fusionnés en fin de run)
+    RunLedger   *fLedger    = nullptr;   // compteurs sans verrou du MÊME thread
+    StepTracer  *fTracer    = nullptr;   // suivi step par step (décision par événement)
 
     G4int fSteppingVerboseLevel = 0;
     SteppingMessenger* fSteppingMessenger;
 
-    // ==================== Step Tracking ====================
-    static G4int fMaxTrackedEvents;           // Nombre max d'événements à suivre
-    static G4int fTrackedEventsCount;         // Compteur d'événements suivis
-    static std::set<G4int> fTrackedEventIDs;  // Set des eventID suivis
-    static std::set<G4int> fTrackedTrackIDs;  // Set des trackID à suivre dans l'événement courant
-    static G4int fCurrentEventID;             // EventID courant
-    
-    void PrintStepInfo(const G4Step* step, G4int eventID);
-    G4bool ShouldTrackParticle(const G4Track* track, G4int eventID);
+    // Observateurs par rôle de volume (propres au thread, comme l'action)
+    StepObserverRegistry fObservers;
+    void BuildObservers();
 
 };
 #endif
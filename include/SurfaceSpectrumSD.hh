@@ -9,9 +9,8 @@
 #include <vector>
 #include <string>
 
-#include <set>
-
 // Fwds
+class RunLedger;
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
@@ -92,7 +91,7 @@ private:
   // ---------------------------------------------------------------------------
   // Données internes
   // ---------------------------------------------------------------------------
-  std::vector<G4double> fBins;   // [DOC] histogramme (compte par bin)
+  std::vector<G4double> fBins;   // [DOC] histogramme (somme des poids par bin)
   G4int   fVerbose      = 0;
 
   // ID de l’ntuple "plane_passages" (G4Analysis)
@@ -105,11 +104,11 @@ private:
   G4long  fRowsTotal     = 0;   // [DOC] total lignes écrites depuis le début du run (par thread)
   G4int   fDbgMaxPrint   = 10;  // [DOC] imprime les 10 premières lignes puis chaque 1000e
 
-  G4long fCntEnter = 0;   // pas entrant dans le plan (pre!=plan, post==plan)
-  G4long fCntLeave = 0;   // pas sortant du plan (pre==plan, post!=plan)
-  G4long fCntOut   = 0;   // sous-ensemble leave qui sont "outward" si filtre actif
-  G4long fCntRows  = 0;   // lignes réellement écrites dans l’ntuple
-  std::set<int> fEventsPrimaryCounted; // événements primaires pour lesquels on a écrit au moins 1 ligne
+  // [FIX] Compteurs enter/leave/outward/rows et logs : slots Ledger::kSpec* du RunLedger
+  //       du thread (fusionnés en fin de run, plus de "static int" partagés entre threads)
+  RunLedger* fLedger = nullptr;
+  G4int   fLastPrimaryEventCounted = -1; // dernier événement avec une ligne primaire (remplace un std::set)
+  G4int   fLastPrimarySlotCounted  = -1; // et rang du primaire (événements multi-photons)
 
 };
 
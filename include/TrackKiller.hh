@@ -0,0 +1,85 @@
+#ifndef TRACKKILLER_HH
+#define TRACKKILLER_HH
+
+#include "DetectorConstruction.hh"
+
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+#include <cmath>
+
+class TrackKillerMessenger;
+
+// ============================================================================
+// TrackKiller : arrêt géométrique des tracks qui ne peuvent plus atteindre
+//               aucun scoreur (ScorePlane..ScorePlane5, couronnes d'eau)
+//
+//  Tous les scoreurs sont dans |x|, |y| <= 50 mm et z <= 70.5 mm. La règle
+//  n'est évaluée qu'aux frontières géométriques (fGeomBoundary), par des
+//  tests sur la position et la direction du point post-step :
+//    - backward : z < zBackward et dir.z <= 0 (retour vers le corps du tube) ;
+//    - side     : sortie latérale de logicEnveloppeGDML, |x| ou |y| >= 50 mm
+//                 en s'éloignant de l'axe (rien ne la ramène, hors air du monde) ;
+//    - beyond   : z >= zBeyond (après ScorePlane5) et dir.z >= 0.
+//  gamma, e- et e+ uniquement. Ce n'est PAS une roulette : une rétrodiffusion
+//  ultérieure (anode, inox du tube, air du monde) est négligée, d'où une règle
+//  désactivée par défaut et réglable règle par règle.
+//
+//  Configuration (macro /killer/, fixée avant le run, partagée par les threads) :
+//    /killer/enable true|false
+//    /killer/backward true|false   /killer/backwardZ <z> mm
+//    /killer/side true|false
+//    /killer/beyond true|false     /killer/beyondZ <z> mm
+//  Les tracks arrêtés sont tallyés par volume quitté (nombre, énergie
+//  cinétique pondérée) par RunAction, et le bilan de fin de run estime le
+//  temps de calcul économisé.
+// ============================================================================
+class TrackKiller
+{
+public:
+    enum Rule : G4int { kNone = 0, kBackward, kSide, kBeyond };
+
+    // Messenger /killer/ (master / SEQ uniquement, sans effet ailleurs)
+    static void Init();
+
+    // ----- Configuration (master, avant le run) -----
+    static void SetEnabled(G4bool on)       { fEnabled = on; }
+    static void SetBackward(G4bool on)      { fBackward = on; }
+    static void SetBackwardZ(G4double z)    { fBackwardZ = z; }
+    static void SetSide(G4bool on)          { fSide = on; }
+    static void SetBeyond(G4bool on)        { fBeyond = on; }
+    static void SetBeyondZ(G4double z)      { fBeyondZ = z; }
+
+    static inline G4bool IsEnabled()        { return fEnabled; }
+
+    // Règle satisfaite par un point de frontière (kNone si le track peut encore scorer)
+    static inline G4int Evaluate(const G4ThreeVector& pos, const G4ThreeVector& dir) {
+        if (fBackward && pos.z() < fBackwardZ && dir.z() <= 0.) return kBackward;
+        constexpr G4double edge = DetectorConstruction::kEnveloppeHalfXY - kEdgeTolerance;
+        if (fSide && ((std::abs(pos.x()) >= edge && pos.x() * dir.x() >= 0.) ||
+                      (std::abs(pos.y()) >= edge && pos.y() * dir.y() >= 0.))) return kSide;
+        if (fBeyond && pos.z() >= fBeyondZ && dir.z() >= 0.) return kBeyond;
+        return kNone;
+    }
+
+    static const char* RuleName(G4int rule);
+
+    // Début de run : politique imprimée (master/SEQ)
+    static void BeginRun();
+
+private:
+    // Un point de frontière sur une face latérale peut tomber juste en deçà de 50 mm
+    static constexpr G4double kEdgeTolerance = 1.*CLHEP::um;
+
+    static G4bool   fEnabled;
+    static G4bool   fBackward;
+    static G4double fBackwardZ;
+    static G4bool   fSide;
+    static G4bool   fBeyond;
+    static G4double fBeyondZ;
+
+    static TrackKillerMessenger* fMessenger;
+};
+
+#endif
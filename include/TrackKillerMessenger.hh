@@ -0,0 +1,28 @@
+#ifndef TrackKillerMessenger_h
+#define TrackKillerMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+
+class TrackKillerMessenger : public G4UImessenger {
+public:
+    TrackKillerMessenger();
+    virtual ~TrackKillerMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithABool* fBackwardCmd;
+    G4UIcmdWithADoubleAndUnit* fBackwardZCmd;
+    G4UIcmdWithABool* fSideCmd;
+    G4UIcmdWithABool* fBeyondCmd;
+    G4UIcmdWithADoubleAndUnit* fBeyondZCmd;
+};
+
+#endif
@@ -4,13 +4,56 @@
 #include "G4UserTrackingAction.hh"
 #include "globals.hh"
 
+#include <vector>
+
+class TrackingMessenger;
+class StepTracer;
+class RunLedger;
+class MyTrackInfo;
+
+// ============================================================================
+// Stockage des trajectoires selon le mode d'exécution
+//
+//  - kOn      : une G4Trajectory par track (visualisation, session interactive)
+//  - kOff     : aucune trajectoire (batch : pas d'allocation ni de points)
+//  - kSampled : trajectoires d'un événement sur N seulement
+//
+//  Le mode par défaut est choisi par sim.cc (interactif => kOn, batch => kOff)
+//  et peut être changé par macro : /trajectories/mode, /trajectories/every.
+// ============================================================================
 class TrackingAction : public G4UserTrackingAction
 {
 public:
-    TrackingAction();
-    virtual ~TrackingAction() = default;
+    enum TrajectoryMode : G4int { kOff = 0, kOn, kSampled };
+
+    explicit TrackingAction(TrajectoryMode mode = kOff);
+    virtual ~TrackingAction();
 
     virtual void PreUserTrackingAction(const G4Track* track);
+
+    void SetTrajectoryMode(TrajectoryMode mode) { fMode = mode; fLastEventID = -1; }
+    void SetTrajectoryEvery(G4int n)            { fEvery = (n > 0) ? n : 1; fLastEventID = -1; }
+    TrajectoryMode GetTrajectoryMode() const    { return fMode; }
+
+    static const char* ModeName(TrajectoryMode mode);
+
+private:
+    TrajectoryMode fMode;
+    StepTracer* fTracer;           // décision "événement suivi" (MyTrackInfo::IsTraced)
+    RunLedger*  fLedger;           // compteur de tracks (coût moyen, bilan TrackKiller)
+    G4int fEvery = 100;            // kSampled : 1 événement sur fEvery
+
+    // Décision du mode kSampled, prise au premier track de chaque événement
+    G4int  fLastEventID = -1;
+    G4bool fStoreThisEvent = false;
+
+    // Événements multi-photons : rang du primaire de chaque track de l'événement
+    // (indexé par trackID, un parent est toujours suivi avant ses secondaires)
+    void AssignPrimarySlot(const G4Track* track, MyTrackInfo* info);
+    G4int fSlotEventID = -1;
+    std::vector<G4int> fSlotOfTrack;
+
+    TrackingMessenger* fTrackingMessenger;
 };
 
 #endif
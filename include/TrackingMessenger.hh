@@ -0,0 +1,26 @@
+#ifndef TrackingMessenger_h
+#define TrackingMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class TrackingAction;
+
+class TrackingMessenger : public G4UImessenger {
+public:
+    TrackingMessenger(TrackingAction* tracking);
+    virtual ~TrackingMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    TrackingAction* fTracking;
+    G4UIdirectory* fDir;
+    G4UIcmdWithAString* fModeCmd;
+    G4UIcmdWithAnInteger* fEveryCmd;
+};
+
+#endif
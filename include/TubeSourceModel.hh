@@ -0,0 +1,102 @@
+#ifndef TUBESOURCEMODEL_HH
+#define TUBESOURCEMODEL_HH
+
+#include "AliasTable.hh"
+#include "SpectrumSampler.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class TubeSourceModelMessenger;
+
+// ============================================================================
+// TubeSourceModel : source de tube paramétrée (source 5), sans simulation du
+//                   tube : foyer 2D mesuré + effet talon (spectre fonction de
+//                   l'angle d'émission)
+//
+//  Deux tables lues dans des fichiers (/tubesource/focalSpot, /heelTable),
+//  construites UNE fois par le master / SEQ, puis seulement lues par les
+//  workers (même principe que SpectrumLibrary). Une table chargée n'est
+//  jamais détruite : recharger un fichier ne fait que changer la table
+//  courante, à prendre en compte au run suivant.
+//
+//  Foyer (focalSpot) : carte d'intensité sur une grille régulière centrée
+//  sur l'axe, au plan z de la source ponctuelle (ou "# z_mm:").
+//    # dx_mm: 0.02          pas en x (colonnes)
+//    # dy_mm: 0.02          pas en y (lignes)
+//    <I(x0,y0)> <I(x1,y0)> ...     une ligne par y croissant
+//  Tirage : pixel par table d'alias, position uniforme dans le pixel.
+//
+//  Effet talon (heelTable) : spectres par unité d'angle solide à des angles
+//  theta (par rapport à +z) croissants, E croissantes pour chaque angle :
+//    <theta en deg>  <E en keV>  <intensité par sr et par keV>
+//  Entre deux angles, l'intensité est interpolée linéairement en cos(theta) :
+//  (1-t) S_k(E) + t S_k+1(E). Chaque terme est une entrée d'une table
+//  d'alias commune (poids = intégrale du terme sur l'angle solide), puis
+//  t est tiré par inversion (densité 1-t ou t) et E dans S_k ou S_k+1.
+//  Le couple (angle, énergie) est donc tiré de la loi jointe, sans rejet.
+//  Spectres tronqués à E > PrimaryGeneratorAction2::kEcut.
+// ============================================================================
+class TubeSourceModel
+{
+public:
+    struct FocalSpot {
+        G4String file;
+        std::uint32_t nx = 0, ny = 0;
+        G4double x0 = 0., y0 = 0.;           // coin (xmin, ymin) de la grille
+        G4double dx = 0., dy = 0.;
+        G4double z  = 0.;
+        std::vector<std::uint32_t> pixels;   // indices ix + nx*iy des pixels non nuls
+        AliasTable alias;
+
+        // u0 choisit le pixel, (u1, u2) la position dans le pixel
+        inline G4ThreeVector Sample(G4double u0, G4double u1, G4double u2) const {
+            const std::uint32_t p = pixels[alias.Sample(u0)];
+            return G4ThreeVector(x0 + (p % nx + u1)*dx, y0 + (p / nx + u2)*dy, z);
+        }
+    };
+
+    struct HeelTable {
+        G4String file;
+        std::vector<G4double> theta;         // angles tabulés (croissants)
+        std::vector<G4double> cosTheta;
+        std::vector<G4double> yield;         // intégrale de S_k au-dessus de kEcut (par sr)
+        std::vector<SpectrumSampler> spectra;
+        AliasTable alias;                    // entrée 2k + e : intervalle k, extrémité e
+
+        // u0 : terme (intervalle, extrémité) ; u1 : angle ; u2, u3 : énergie
+        inline void Sample(G4double u0, G4double u1, G4double u2, G4double u3,
+                           G4double& cosT, G4double& energy) const {
+            const std::size_t j = alias.Sample(u0);
+            const std::size_t k = j >> 1, e = j & 1;
+            const G4double t = e ? std::sqrt(u1) : 1. - std::sqrt(1. - u1);
+            cosT = cosTheta[k] + t*(cosTheta[k + 1] - cosTheta[k]);
+            energy = spectra[k + e].Sample(u2, u3);
+        }
+    };
+
+    // Messenger /tubesource/ (master / SEQ uniquement, sans effet ailleurs)
+    static void Init();
+
+    static G4bool LoadFocalSpot(const G4String& file);
+    static G4bool LoadHeelTable(const G4String& file);
+
+    // Tables courantes (nullptr si non chargées) : lues par PrimaryGeneratorAction5
+    static const FocalSpot* GetFocalSpot() { return fFocalSpot; }
+    static const HeelTable* GetHeelTable() { return fHeelTable; }
+
+    static void Print();
+
+private:
+    static std::vector<std::unique_ptr<FocalSpot>> fFocalSpots;
+    static std::vector<std::unique_ptr<HeelTable>> fHeelTables;
+    static const FocalSpot* fFocalSpot;
+    static const HeelTable* fHeelTable;
+    static TubeSourceModelMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef TubeSourceModelMessenger_h
+#define TubeSourceModelMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+class TubeSourceModelMessenger : public G4UImessenger {
+public:
+    TubeSourceModelMessenger();
+    virtual ~TubeSourceModelMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4UIdirectory* fDir;
+    G4UIcmdWithAString* fFocalSpotCmd;
+    G4UIcmdWithAString* fHeelTableCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef VOLUMEROLES_HH
+#define VOLUMEROLES_HH
+
+#include "G4LogicalVolume.hh"
+#include "globals.hh"
+
+#include <vector>
+
+// ============================================================================
+// VolumeRoles : table "volume logique -> rôle" résolue UNE fois après
+// DetectorConstruction::Construct()
+//
+//  - les noms de volumes ("logicScorePlane", "logicWaterRingN", ...) ne sont
+//    comparés qu'à la construction de la table (VolumeRoles::Build()) ;
+//  - en cours de run, SteppingAction ne fait plus qu'un accès indexé par
+//    G4LogicalVolume::GetInstanceID() (dense, 0..N-1) puis des switch/==
+//    sur des entiers ;
+//  - la table est construite par le master avant le démarrage des workers,
+//    puis seulement lue : aucune synchronisation nécessaire en MT.
+// ============================================================================
+namespace VolumeRole
+{
+    enum Role : G4int {
+        kOther = 0,       // volume sans traitement particulier
+        kBeWindow,        // MiniX-TubeXFenetreBeryllium-Beryllium
+        kScorePlane,      // logicScorePlane (plan SpecSD)
+        kWaterRing,       // logicWaterRing0..4 (index dans VolumeInfo::ringIndex)
+        kConeCompton,     // logicConeCompton (cône graphite)
+        kEnveloppe,       // logicEnveloppeGDML
+        kWaterCube,       // logicWaterCube
+        kSphereWater,     // logicsphereWater
+        kNbRoles
+    };
+}
+
+struct VolumeInfo
+{
+    G4int  role        = VolumeRole::kOther;
+    G4int  ringIndex   = -1;      // >= 0 uniquement pour kWaterRing
+    G4bool isStainless = false;   // matériau StainlessSteel304 (absorptions inox)
+};
+
+class VolumeRoles
+{
+public:
+    // (Re)construit la table depuis G4LogicalVolumeStore (appelé en fin de Construct())
+    static void Build();
+
+    // Rôle d'un volume logique (nullptr ou volume inconnu -> kOther)
+    static inline const VolumeInfo& Of(const G4LogicalVolume* lv) {
+        if (!lv) return fUnknown;
+        const auto id = static_cast<std::size_t>(lv->GetInstanceID());
+        return (id < fTable.size()) ? fTable[id] : fUnknown;
+    }
+
+    static const char* RoleName(G4int role);
+    static void Print();
+
+private:
+    static std::vector<VolumeInfo> fTable;   // indexé par G4LogicalVolume::GetInstanceID()
+    static const VolumeInfo fUnknown;
+};
+
+#endif
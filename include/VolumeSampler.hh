@@ -0,0 +1,62 @@
+#ifndef VOLUMESAMPLER_HH
+#define VOLUMESAMPLER_HH
+
+#include "AliasTable.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class G4LogicalVolume;
+class G4VSolid;
+
+// ============================================================================
+// VolumeSampler : tirage uniforme en O(1) dans un solide, sans Inside()
+//                 pendant la boucle d'événements
+//
+//  Build() découpe la boîte [lo, hi] ∩ extent du solide en voxels cubiques
+//  d'arête ~voxelSize et teste Inside() sur k^3 points stratifiés par voxel
+//  (une seule fois). Seuls les voxels touchés sont gardés, avec un poids
+//  égal à la fraction de points intérieurs ; une table d'alias choisit le
+//  voxel, puis le point est uniforme dans le voxel.
+//  Écart à la densité exacte limité aux voxels coupés par la surface
+//  (épaisseur ~ voxelSize). Coordonnées dans le repère du solide.
+//  Construit une fois, puis lu seul : partageable entre threads.
+// ============================================================================
+class VolumeSampler
+{
+public:
+    // Renvoie false si aucun voxel n'est intérieur (sampler vide)
+    G4bool Build(const G4VSolid* solid, const G4ThreeVector& lo, const G4ThreeVector& hi,
+                 G4double voxelSize, G4int pointsPerAxis = 2);
+    G4bool Build(const G4LogicalVolume* volume, const G4ThreeVector& lo, const G4ThreeVector& hi,
+                 G4double voxelSize, G4int pointsPerAxis = 2);
+
+    inline G4bool      Empty() const     { return fAlias.Empty(); }
+    inline std::size_t NbVoxels() const  { return fVoxels.size(); }
+    inline G4double    Volume() const    { return fVolume; }       // volume estimé du solide dans [lo, hi]
+    inline const G4ThreeVector& Lo() const    { return fLo; }
+    inline const G4ThreeVector& Hi() const    { return fHi; }
+    inline const G4ThreeVector& Pitch() const { return fPitch; }
+
+    // u0 choisit le voxel, (u1, u2, u3) la position dans le voxel ; tous dans [0,1[
+    inline G4ThreeVector Sample(G4double u0, G4double u1, G4double u2, G4double u3) const {
+        const std::uint32_t v  = fVoxels[fAlias.Sample(u0)];
+        const std::uint32_t ix = v % fNx;
+        const std::uint32_t iy = (v / fNx) % fNy;
+        const std::uint32_t iz = v / (fNx * fNy);
+        return G4ThreeVector(fLo.x() + (ix + u1)*fPitch.x(),
+                             fLo.y() + (iy + u2)*fPitch.y(),
+                             fLo.z() + (iz + u3)*fPitch.z());
+    }
+
+private:
+    std::vector<std::uint32_t> fVoxels;   // indices ix + nx*(iy + ny*iz) des voxels touchés
+    AliasTable    fAlias;
+    G4ThreeVector fLo, fHi, fPitch;
+    std::uint32_t fNx = 0, fNy = 0, fNz = 0;
+    G4double      fVolume = 0.;
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef WATERMUEN_HH
+#define WATERMUEN_HH
+
+#include "globals.hh"
+
+// ============================================================================
+// WaterMuEn : coefficient massique d'absorption en énergie de l'eau liquide
+//
+//  Table NIST (Hubbell & Seltzer, NISTIR 5632) de 1 keV à 2 MeV, interpolée
+//  en log-log. Sert à l'estimateur de kerma par longueur de trace dans les
+//  couronnes d'eau (WaterRingKermaObserver) :
+//    K = somme sur les steps de photon de  w * L * rho * (mu_en/rho)(E) * E
+//  En dessous de 1 keV / au-dessus de 2 MeV la valeur du bord est retournée.
+// ============================================================================
+namespace WaterMuEn
+{
+    // mu_en/rho (unités internes Geant4 : surface / masse) à l'énergie e
+    G4double MassEnergyAbsorption(G4double e);
+}
+
+#endif
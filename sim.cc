@@ -1,14 +1,22 @@
 #include <iostream>
 #include <fstream>
 #include <cstdio> // pour freopen
+#include <cstdlib>
+#include <string>
+#include <vector>
 
 #include "G4RunManagerFactory.hh"
 #include "G4RunManager.hh"
-#include "G4MTRunManager.hh"
 #include "G4Threading.hh"
 
 #include "FTFP_BERT.hh"
 #include "G4StepLimiterPhysics.hh"
+#include "G4GeometrySampler.hh"
+#include "G4ImportanceBiasing.hh"
+#include "G4ParallelWorldPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
+#include "G4EmParameters.hh"
+#include "G4SystemOfUnits.hh"
 
 #include "G4UImanager.hh"
 #include "G4UIExecutive.hh"
@@ -19,6 +27,7 @@
 #include "DetectorConstruction.hh"
 #include "PhysicsList.hh"
 #include "ActionInitialization.hh"
+#include "ImportanceWorld.hh"
 
 #include "G4ios.hh"
 
@@ -46,45 +55,152 @@ struct LogGuard {
   }
 };
 
+// ===== Usage =====
+//   ./sim                                   -> session interactive (init_vis.mac), mode séquentiel
+//   ./sim run.mac                           -> batch, mode séquentiel
+//   ./sim run.mac -m mt -t 32               -> batch, multithread 32 threads
+//   ./sim run.mac -m tasking -t 32          -> batch, tasking (TBB/PTL) 32 threads
+//   ./sim run.mac -m mt -t 32 -i            -> idem + splitting/roulette géométrique
+//                                              des gammas (importances : /importance/)
+//   ./sim run.mac -m mt -t 32 -f            -> idem + Compton forcé dans le cône graphite
+//                                              (forced collision, poids corrigés)
+//   ./sim run.mac -m mt -t 32 -b 100        -> idem + splitting directionnel (x100) du
+//                                              bremsstrahlung dans l'anode (source 3)
+// Le nombre de threads peut aussi être fixé dans la macro (/run/numberOfThreads N,
+// avant /run/initialize) ; il est ignoré en mode séquentiel.
+namespace {
+  void PrintUsage() {
+    G4cerr << " Usage: sim [macro] [-m serial|mt|tasking] [-t nThreads] [-i] [-f] [-b N]" << G4endl;
+  }
+
+  G4RunManagerType ParseRunManagerType(const std::string& mode) {
+    if (mode == "serial" || mode == "seq") return G4RunManagerType::Serial;
+    if (mode == "mt")                      return G4RunManagerType::MT;
+    if (mode == "tasking")                 return G4RunManagerType::Tasking;
+    G4cerr << "[WARN] Mode inconnu '" << mode << "' -> serial" << G4endl;
+    return G4RunManagerType::Serial;
+  }
+
+  const char* ModeName(G4RunManagerType type) {
+    switch (type) {
+      case G4RunManagerType::MT:      return "MT";
+      case G4RunManagerType::Tasking: return "Tasking";
+      default:                        return "Serial";
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
 
   // Capture EVERYTHING (banner, geometry init, run, summaries) in a single file
   LogGuard lg("geant4_run_full.log");
 
+  // Lecture des arguments : macro + options -m / -t
   G4String macrofile = "";
+  G4RunManagerType rmType = G4RunManagerType::Serial;  // défaut historique
+  G4int nThreads = 0;                                   // 0 = défaut Geant4 / macro
+  G4bool useImportance = false;                         // monde d'importance (option -i)
+  G4bool forcedCompton = false;                         // Compton forcé dans le cône (option -f)
+  G4int bremSplitting = 0;                              // facteur de splitting du brem (option -b)
+  for (G4int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-m" && i + 1 < argc) {
+      rmType = ParseRunManagerType(argv[++i]);
+    } else if (arg == "-t" && i + 1 < argc) {
+      nThreads = std::atoi(argv[++i]);
+    } else if (arg == "-i") {
+      useImportance = true;
+    } else if (arg == "-f") {
+      forcedCompton = true;
+    } else if (arg == "-b" && i + 1 < argc) {
+      bremSplitting = std::atoi(argv[++i]);
+    } else if (arg[0] != '-' && macrofile.empty()) {
+      macrofile = arg;
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+
   G4UIExecutive* ui  = nullptr;
-  if ( argc == 1 ) {     // cas pas de macro file
+  if ( macrofile.empty() ) {     // cas pas de macro file
     ui = new G4UIExecutive(argc, argv);
-  } else {
-    macrofile = argv[1]; // cas macrofile
   }
 
 
-  // ✅ Création du run manager avec factory
-  auto* runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Serial);
-
-  // ✅ Force l'exécution en mono-thread (si MT activé)
-  #ifdef G4MULTITHREADED
-  auto* mtManager = dynamic_cast<G4MTRunManager*>(runManager);
-  if (mtManager) {
-    mtManager->SetNumberOfThreads(1);
-    G4cout << "[INFO] Mode mono-thread forcé avec G4MTRunManager." << G4endl;
-  }
-  #endif
+  // ✅ Création du run manager avec factory (Serial / MT / Tasking)
+  //    Si Geant4 n'est pas compilé en MT, la factory retombe sur Serial.
+  auto* runManager = G4RunManagerFactory::CreateRunManager(rmType, /*fail_if_unavail=*/false, nThreads);
+  G4cout << "[INFO] Run manager demandé : " << ModeName(rmType)
+         << " | threads = " << (nThreads > 0 ? std::to_string(nThreads) : "défaut/macro")
+         << G4endl;
 
   // Définition de la construction du détecteur
   auto* detector = new DetectorConstruction();
+
+  // Monde parallèle d'importance (tranches en z) : enregistré avant l'initialisation
+  if (useImportance) {
+    detector->RegisterParallelWorld(new ImportanceWorld(ImportanceWorld::kWorldName));
+  }
+  detector->SetForcedCompton(forcedCompton);
+  detector->SetBremSplitting(bremSplitting > 1);
   runManager->SetUserInitialization(detector);
 
   // Définition de la liste de physique
   //auto* physicsList = new PhysicsList();
   auto physicsList = new FTFP_BERT;
   physicsList->RegisterPhysics(new G4StepLimiterPhysics());
+
+  // Splitting / roulette russe des gammas aux frontières des tranches d'importance.
+  // Le monde du sampler est fixé par G4ImportanceBiasing (monde parallèle nommé).
+  G4GeometrySampler* importanceSampler = nullptr;
+  if (useImportance) {
+    importanceSampler = new G4GeometrySampler(nullptr, "gamma");
+    importanceSampler->SetParallel(true);
+    physicsList->RegisterPhysics(new G4ImportanceBiasing(importanceSampler, ImportanceWorld::kWorldName));
+    physicsList->RegisterPhysics(new G4ParallelWorldPhysics(ImportanceWorld::kWorldName));
+    G4cout << "[INFO] Biais d'importance géométrique : ACTIVÉ (monde '"
+           << ImportanceWorld::kWorldName << "')" << G4endl;
+  }
+
+  // Biais générique : seul "compt" des gammas est enveloppé (phot, Rayl restent
+  // analogues) ; le non-physique porte le clonage de G4BOptrForceCollision.
+  // L'opérateur est attaché au cône dans DetectorConstruction::ConstructSDandField.
+  if (forcedCompton) {
+    auto* biasing = new G4GenericBiasingPhysics();
+    biasing->PhysicsBias("gamma", std::vector<G4String>{"compt"});
+    biasing->NonPhysicsBias("gamma");
+    physicsList->RegisterPhysics(biasing);
+    G4cout << "[INFO] Compton forcé dans logicConeCompton : ACTIVÉ" << G4endl;
+  }
+
+  // Splitting directionnel du bremsstrahlung (DBS) des électrons dans l'anode :
+  // chaque photon de freinage est tiré N fois ; ceux qui visent la sphère cible
+  // sont gardés avec le poids w/N, les autres subissent une roulette russe
+  // (survie 1/N, poids w).
+  // [FIX] Cible = ouverture de sortie du cône graphite, (0, 0, 16.95 mm), R = 1 mm ;
+  //       l'ancienne sphère (0, 0, 1.9 mm) de 3.5 mm contenait le foyer.
+  // Cible et rayon modifiables par macro avant /run/initialize :
+  //   /process/em/setDirSplittingTarget 0 0 16.95 mm
+  //   /process/em/setDirSplittingRadius 1.0 mm
+  if (bremSplitting > 1) {
+    auto* emParams = G4EmParameters::Instance();
+    emParams->SetDirectionalSplitting(true);
+    emParams->SetDirectionalSplittingTarget(G4ThreeVector(0., 0., 16.95*mm));
+    emParams->SetDirectionalSplittingRadius(1.0*mm);
+    emParams->ActivateSecondaryBiasing("eBrem", DetectorConstruction::kAnodeRegionName,
+                                       bremSplitting, 1.*MeV);
+    G4cout << "[INFO] Splitting directionnel du brem (x" << bremSplitting << ") dans "
+           << DetectorConstruction::kAnodeRegionName << " : ACTIVÉ, cible z = "
+           << emParams->GetDirectionalSplittingTarget().z()/mm << " mm, R = "
+           << emParams->GetDirectionalSplittingRadius()/mm << " mm" << G4endl;
+  }
   runManager->SetUserInitialization(physicsList);
 
   // Définition des actions utilisateur
-  runManager->SetUserInitialization(new ActionInitialization());
+  //    (trajectoires stockées seulement en session interactive, cf. TrackingAction)
+  runManager->SetUserInitialization(new ActionInitialization(/*interactive=*/ui != nullptr));
 
   // set up visualisation
   G4VisManager* visManager = new G4VisExecutive;
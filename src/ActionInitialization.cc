@@ -4,8 +4,17 @@
 #include "G4TrajectoryContainer.hh"
 #include "G4UserTrackingAction.hh"
 #include "TrackingAction.hh"
+#include "StepTracer.hh"
+#include "TrackKiller.hh"
+#include "RangeRejection.hh"
+#include "PhaseSpace.hh"
+#include "SpectrumLibrary.hh"
+#include "TubeSourceModel.hh"
+#include "PlaneTallies.hh"
+#include "DoseMesh.hh"
 
-ActionInitialization::ActionInitialization()
+ActionInitialization::ActionInitialization(G4bool interactive)
+: fInteractive(interactive)
 {}
 
 ActionInitialization::~ActionInitialization()
@@ -15,10 +24,35 @@ void ActionInitialization::BuildForMaster() const
 {
     RunAction *runAction = new RunAction();
     SetUserAction(runAction);
+
+    // Messenger /tracer/ : configuration du suivi step par step, partagée par les workers
+    StepTracer::Instance();
+    // Messengers /killer/ et /rangeRejection/ : politiques d'arrêt, partagées par les workers
+    TrackKiller::Init();
+    RangeRejection::Init();
+    // Messenger /phasespace/ : écriture / rejeu de l'espace des phases
+    PhaseSpace::Init();
+    // Spectres spectrum_*.dat : tables de tirage construites une fois, lues par les workers
+    SpectrumLibrary::Init();
+    // Messenger /tubesource/ : foyer et effet talon de la source 5, tables partagées
+    TubeSourceModel::Init();
+    // Messenger /tallies/ : sortie des plans de comptage (ntuples et/ou histogrammes)
+    PlaneTallies::Init();
+    // Messenger /dosemesh/ : maillage 3D de dose, grille partagée
+    DoseMesh::Init();
 }
 
 void ActionInitialization::Build() const
 {
+    // Mode séquentiel : pas de BuildForMaster, messengers /killer/, /rangeRejection/,
+    // /phasespace/, /spectra/, /tubesource/, /tallies/ et /dosemesh/ créés ici
+    TrackKiller::Init();
+    RangeRejection::Init();
+    PhaseSpace::Init();
+    SpectrumLibrary::Init();
+    TubeSourceModel::Init();
+    PlaneTallies::Init();
+    DoseMesh::Init();
 
     auto generator = new PrimaryGeneratorAction();
     SetUserAction(generator);
@@ -32,10 +66,12 @@ void ActionInitialization::Build() const
     SetUserAction(eventAction);
     SetUserAction(runAction);
 
-    auto steppingAction = new SteppingAction(eventAction);
+    auto steppingAction = new SteppingAction(eventAction, runAction);
     SetUserAction(steppingAction);
 
-    auto trackingAction = new TrackingAction();
+    // Trajectoires : stockées en session interactive (vis), pas en batch
+    // (modifiable par macro : /trajectories/mode on|off|sampled)
+    auto trackingAction = new TrackingAction(fInteractive ? TrackingAction::kOn : TrackingAction::kOff);
     SetUserAction(trackingAction);
 
 }
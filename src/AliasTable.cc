@@ -0,0 +1,37 @@
+#include "AliasTable.hh"
+
+void AliasTable::Build(const std::vector<G4double>& weights)
+{
+    fThreshold.clear();
+    fAlias.clear();
+
+    const std::size_t n = weights.size();
+    G4double sum = 0.;
+    for (const G4double w : weights) sum += (w > 0.) ? w : 0.;
+    if (n == 0 || !(sum > 0.)) return;
+
+    // Probabilités remises à l'échelle : moyenne 1 par colonne
+    fThreshold.resize(n);
+    fAlias.resize(n);
+    std::vector<std::uint32_t> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        fThreshold[i] = ((weights[i] > 0.) ? weights[i] : 0.) * n / sum;
+        fAlias[i] = static_cast<std::uint32_t>(i);
+        (fThreshold[i] < 1. ? small : large).push_back(static_cast<std::uint32_t>(i));
+    }
+
+    // Vose : chaque colonne "petite" est complétée par une colonne "grande"
+    while (!small.empty() && !large.empty()) {
+        const std::uint32_t s = small.back(); small.pop_back();
+        const std::uint32_t l = large.back(); large.pop_back();
+        fAlias[s] = l;
+        fThreshold[l] -= 1. - fThreshold[s];
+        (fThreshold[l] < 1. ? small : large).push_back(l);
+    }
+
+    // Restes (arrondis) : colonnes pleines
+    for (const auto i : large) fThreshold[i] = 1.;
+    for (const auto i : small) fThreshold[i] = 1.;
+}
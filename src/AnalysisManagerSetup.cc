@@ -10,6 +10,7 @@
 #include "ScorePlane3SD.hh"
 #include "ScorePlane4SD.hh"
 #include "ScorePlane5SD.hh"
+#include "PlaneTallies.hh"
 // ScorePlane6SD supprimé
 #include "G4Run.hh"
 
@@ -103,10 +104,29 @@ void SetupAnalysis()
     analysisManager->CreateH1("Dose_ring4_10000evt", 
         "Dose anneau 4 (r=8-10mm) 10000evt;Dose (pGy);Counts", 200, 0., 500.);  // ID 14 (pGy)
 
+    // H15-H19: Kerma par anneau (par 10000 événements) - en pGy
+    // Estimateur longueur de trace x mu_en/rho (WaterMuEn), à comparer à H10-H14
+    analysisManager->CreateH1("Kerma_ring0_10000evt", 
+        "Kerma anneau 0 (r=0-2mm) 10000evt;Kerma (pGy);Counts", 200, 0., 500.);  // ID 15 (pGy)
+    analysisManager->CreateH1("Kerma_ring1_10000evt", 
+        "Kerma anneau 1 (r=2-4mm) 10000evt;Kerma (pGy);Counts", 200, 0., 500.);  // ID 16 (pGy)
+    analysisManager->CreateH1("Kerma_ring2_10000evt", 
+        "Kerma anneau 2 (r=4-6mm) 10000evt;Kerma (pGy);Counts", 200, 0., 500.);  // ID 17 (pGy)
+    analysisManager->CreateH1("Kerma_ring3_10000evt", 
+        "Kerma anneau 3 (r=6-8mm) 10000evt;Kerma (pGy);Counts", 200, 0., 500.);  // ID 18 (pGy)
+    analysisManager->CreateH1("Kerma_ring4_10000evt", 
+        "Kerma anneau 4 (r=8-10mm) 10000evt;Kerma (pGy);Counts", 200, 0., 500.);  // ID 19 (pGy)
+
+    // H20-H44 et H2 0-4 : tallies binnés des plans de comptage (/tallies/mode tallies|both)
+    // 5 H1 par plan (E, E_prim, E_sec, E_compton, r) puis une carte x-y (H2), cf. PlaneTallies.hh
+    PlaneTallies::Book();
+
     // ==================== Ntuple plane_passages ====================
     // Ntuple des passages plan +Z (ScorePlane à z = 18 mm)
     // Structure harmonisée avec les autres ntuples (ScorePlane2, ScorePlane3, etc.)
     // Colonnes : pdg, name, is_secondary, x_mm, y_mm, z_mm, ekin_keV, trackID, parentID, creator_process
+    // Tous les ntuples se terminent par une colonne "weight" (poids de la track) :
+    // les grandeurs physiques s'obtiennent en pondérant chaque ligne par ce poids.
     g_planePassageNtupleId = analysisManager->CreateNtuple("plane_passages", "Traversées +Z du plan mince");
     analysisManager->CreateNtupleIColumn(g_planePassageNtupleId, "pdg");             // 0: Code PDG
     analysisManager->CreateNtupleSColumn(g_planePassageNtupleId, "name");            // 1: Nom particule
@@ -124,11 +144,13 @@ void SetupAnalysis()
     analysisManager->CreateNtupleDColumn(g_planePassageNtupleId, "compton_x_mm");    // 12: X dernière diffusion Compton (mm)
     analysisManager->CreateNtupleDColumn(g_planePassageNtupleId, "compton_y_mm");    // 13: Y dernière diffusion Compton (mm)
     analysisManager->CreateNtupleDColumn(g_planePassageNtupleId, "compton_z_mm");    // 14: Z dernière diffusion Compton (mm)
+    // [ADD] Poids statistique de la track (1 en analogue)
+    analysisManager->CreateNtupleDColumn(g_planePassageNtupleId, "weight");          // 15: G4Track::GetWeight()
     analysisManager->FinishNtuple(g_planePassageNtupleId);
 
     // ==================== Ntuple ScorePlane2 ====================
     // Ntuple pour le plan de comptage ScorePlane2 (z = 28 mm)
-    // Colonnes : pdg, name, is_secondary, x_mm, y_mm, ekin_keV, trackID, parentID, creator_process
+    // Colonnes : pdg, name, is_secondary, x_mm, y_mm, ekin_keV, trackID, parentID, creator_process, weight
     g_scorePlane2NtupleId = analysisManager->CreateNtuple("ScorePlane2_passages", 
         "Traversées +Z du plan ScorePlane2");
     analysisManager->CreateNtupleIColumn(g_scorePlane2NtupleId, "pdg");           // 0: Code PDG
@@ -140,11 +162,12 @@ void SetupAnalysis()
     analysisManager->CreateNtupleIColumn(g_scorePlane2NtupleId, "trackID");       // 6: TrackID
     analysisManager->CreateNtupleIColumn(g_scorePlane2NtupleId, "parentID");      // 7: ParentID
     analysisManager->CreateNtupleSColumn(g_scorePlane2NtupleId, "creator_process"); // 8: Processus créateur
+    analysisManager->CreateNtupleDColumn(g_scorePlane2NtupleId, "weight");        // 9: Poids statistique
     analysisManager->FinishNtuple(g_scorePlane2NtupleId);
 
     // ==================== Ntuple ScorePlane3 ====================
     // Ntuple pour le plan de comptage ScorePlane3 (z = 38 mm)
-    // Colonnes : pdg, name, is_secondary, x_mm, y_mm, ekin_keV, trackID, parentID, creator_process
+    // Colonnes : pdg, name, is_secondary, x_mm, y_mm, ekin_keV, trackID, parentID, creator_process, weight
     g_scorePlane3NtupleId = analysisManager->CreateNtuple("ScorePlane3_passages", 
         "Traversées +Z du plan ScorePlane3");
     analysisManager->CreateNtupleIColumn(g_scorePlane3NtupleId, "pdg");             // 0: Code PDG
@@ -156,6 +179,7 @@ void SetupAnalysis()
     analysisManager->CreateNtupleIColumn(g_scorePlane3NtupleId, "trackID");         // 6: TrackID
     analysisManager->CreateNtupleIColumn(g_scorePlane3NtupleId, "parentID");        // 7: ParentID
     analysisManager->CreateNtupleSColumn(g_scorePlane3NtupleId, "creator_process"); // 8: Processus créateur
+    analysisManager->CreateNtupleDColumn(g_scorePlane3NtupleId, "weight");        // 9: Poids statistique
     analysisManager->FinishNtuple(g_scorePlane3NtupleId);
 
     // ==================== Ntuple WaterRings ====================
@@ -172,6 +196,7 @@ void SetupAnalysis()
     analysisManager->CreateNtupleIColumn(g_scorePlane4NtupleId, "trackID");         // 6: TrackID
     analysisManager->CreateNtupleIColumn(g_scorePlane4NtupleId, "parentID");        // 7: ParentID
     analysisManager->CreateNtupleSColumn(g_scorePlane4NtupleId, "creator_process"); // 8: Processus créateur
+    analysisManager->CreateNtupleDColumn(g_scorePlane4NtupleId, "weight");        // 9: Poids statistique
     analysisManager->FinishNtuple(g_scorePlane4NtupleId);
 
     // ==================== Ntuple ScorePlane5 ====================
@@ -187,6 +212,7 @@ void SetupAnalysis()
     analysisManager->CreateNtupleIColumn(g_scorePlane5NtupleId, "trackID");         // 6: TrackID
     analysisManager->CreateNtupleIColumn(g_scorePlane5NtupleId, "parentID");        // 7: ParentID
     analysisManager->CreateNtupleSColumn(g_scorePlane5NtupleId, "creator_process"); // 8: Processus créateur
+    analysisManager->CreateNtupleDColumn(g_scorePlane5NtupleId, "weight");        // 9: Poids statistique
     analysisManager->FinishNtuple(g_scorePlane5NtupleId);
 
     // ==================== Ntuple abs_graphite ====================
@@ -202,6 +228,7 @@ void SetupAnalysis()
     analysisManager->CreateNtupleDColumn(g_absGraphiteNtupleId, "z_mm");                 // 5
     analysisManager->CreateNtupleIColumn(g_absGraphiteNtupleId, "had_compton_in_cone");  // 6: 1 si Compton avant abs
     analysisManager->CreateNtupleIColumn(g_absGraphiteNtupleId, "n_compton_in_cone");    // 7: nb Compton avant abs
+    analysisManager->CreateNtupleDColumn(g_absGraphiteNtupleId, "weight");               // 8: Poids statistique
     analysisManager->FinishNtuple(g_absGraphiteNtupleId);
 
     // ==================== Ntuple abs_inox ====================
@@ -218,6 +245,7 @@ void SetupAnalysis()
     analysisManager->CreateNtupleSColumn(g_absInoxNtupleId, "volume");               // 6: nom du volume logique
     analysisManager->CreateNtupleIColumn(g_absInoxNtupleId, "had_compton_in_cone");  // 7: 1 si Compton avant abs
     analysisManager->CreateNtupleIColumn(g_absInoxNtupleId, "n_compton_in_cone");    // 8: nb Compton avant abs
+    analysisManager->CreateNtupleDColumn(g_absInoxNtupleId, "weight");               // 9: Poids statistique
     analysisManager->FinishNtuple(g_absInoxNtupleId);
 
     // ==================== Ntuple compton_cone_events ====================
@@ -247,6 +275,7 @@ void SetupAnalysis()
     analysisManager->CreateNtupleDColumn(g_comptonConeNtupleId, "phi_out_deg");        // 13: Angle azimutal sortant (deg)
     analysisManager->CreateNtupleDColumn(g_comptonConeNtupleId, "scatter_angle_deg");  // 14: Angle de diffusion Compton (deg)
     analysisManager->CreateNtupleDColumn(g_comptonConeNtupleId, "cos_scatter");        // 15: cos(angle de diffusion) → vérif. formule Compton
+    analysisManager->CreateNtupleDColumn(g_comptonConeNtupleId, "weight");             // 16: Poids statistique du photon
     analysisManager->FinishNtuple(g_comptonConeNtupleId);
 
     // Ntuple ScorePlane6 supprimé
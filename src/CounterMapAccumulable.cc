@@ -0,0 +1,30 @@
+#include "CounterMapAccumulable.hh"
+
+void CounterMapAccumulable::Merge(const G4VAccumulable& other)
+{
+    const auto& rhs = static_cast<const CounterMapAccumulable&>(other);
+    for (const auto& kv : rhs.fCounts) {
+        fCounts[kv.first] += kv.second;
+    }
+    for (const auto& kv : rhs.fSums) {
+        fSums[kv.first] += kv.second;
+    }
+}
+
+void CounterMapAccumulable::Reset()
+{
+    fCounts.clear();
+    fSums.clear();
+}
+
+#if G4VERSION_NUMBER >= 1130
+void CounterMapAccumulable::Print(G4PrintOptions) const
+{
+    G4cout << "[ACC] " << GetName() << G4endl;
+    for (const auto& kv : fCounts) {
+        G4cout << "  " << kv.first << " : " << kv.second;
+        if (fSums.count(kv.first)) G4cout << " (sum=" << GetSum(kv.first) << ")";
+        G4cout << G4endl;
+    }
+}
+#endif
@@ -25,12 +25,14 @@
 #include "ScorePlane3SD.hh"
 #include "ScorePlane4SD.hh"
 #include "ScorePlane5SD.hh"
+#include "VolumeRoles.hh"
 // ScorePlane6SD supprimé
 
 #include "G4AnalysisManager.hh"
 #include "G4UserLimits.hh"
 
 #include "G4LogicalVolumeStore.hh"
+#include "G4BOptrForceCollision.hh"
 #include "G4Material.hh"
 #include <set>
 #include <string>
@@ -244,8 +246,8 @@ void DetectorConstruction::ConstructGDML()
         G4GDMLParser parser;
 
         // --- Enveloppe cubique centrée en (0,0,0), matériau : air ---
-        const G4double hx = 5.0*cm;    // demi-dimension X = 50 mm
-        const G4double hy = 5.0*cm;    // demi-dimension Y = 50 mm
+        const G4double hx = kEnveloppeHalfXY;   // demi-dimension X = 50 mm
+        const G4double hy = kEnveloppeHalfXY;   // demi-dimension Y = 50 mm
         const G4double hz = 6.0*cm;    // demi-dimension Z = 60 mm
 
         auto solidEnveloppe  = new G4Box("solidEnveloppeGDML", hx, hy, hz);
@@ -940,6 +942,18 @@ void DetectorConstruction::ConstructGDML()
 
                 G4cout << "[DetectorConstruction] Cuts appliqués : 1 µm pour gamma, e-, e+, proton" << G4endl;
 }
+
+        // Région de l'anode pour le splitting directionnel du bremsstrahlung
+        // (G4EmParameters::ActivateSecondaryBiasing, option -b). Une région sans
+        // cuts prendrait ceux par défaut de la liste de physique : on partage
+        // donc ceux de la région du monde pour garder la même physique.
+        if (fBremSplitting && fLogicAnode) {
+                auto* anodeRegion = new G4Region(kAnodeRegionName);
+                anodeRegion->AddRootLogicalVolume(fLogicAnode);
+                if (defaultRegion) anodeRegion->SetProductionCuts(defaultRegion->GetProductionCuts());
+                G4cout << "[DetectorConstruction] Région " << kAnodeRegionName
+                       << " : " << fLogicAnode->GetName() << G4endl;
+        }
 }
 
 // =====================================================
@@ -1038,6 +1052,12 @@ G4VPhysicalVolume *DetectorConstruction::Construct()
                         G4cout << "[GEOM] Envelope: z ∈ [-60, +60] mm" << G4endl;
         }
 
+        // [ADD] Résolution unique nom -> rôle des volumes logiques (lue par SteppingAction)
+        VolumeRoles::Build();
+
+        // Nouvelle géométrie : invalide la table de voxels de l'anode (source 2)
+        ++fGeometryVersion;
+
         return physWorld;
 }
 
@@ -1272,6 +1292,24 @@ void DetectorConstruction::ConstructSDandField()
                 }
         }
 
+        // =====================================================
+        // Biais forced collision : au moins un Compton par gamma traversant
+        // logicConeCompton (seul "compt" est enveloppé, cf. sim.cc -f).
+        // Le photon est cloné à l'entrée : une copie traverse sans interagir
+        // (poids × exp(-τ)), l'autre interagit (poids × (1 - exp(-τ))).
+        // Opérateur thread-local : créé ici, sur chaque worker.
+        // =====================================================
+        if (fForcedCompton) {
+                auto* lvCone = lvStore->GetVolume("logicConeCompton", false);
+                if (lvCone) {
+                        auto* forceCollision = new G4BOptrForceCollision("gamma", "ForcedComptonCone");
+                        forceCollision->AttachTo(lvCone);
+                        G4cout << "[BIAS] Forced collision (gamma, compt) attached to " << lvCone->GetName() << G4endl;
+                } else {
+                        G4cout << "[ERROR] LV 'logicConeCompton' not found - forced Compton not applied" << G4endl;
+                }
+        }
+
 }
 
 void DetectorConstruction::PrintUsedMaterials()
@@ -0,0 +1,329 @@
+#include "DoseMesh.hh"
+#include "DoseMeshMessenger.hh"
+#include "PhaseSpace.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    // [ADD] Helper de logs : SEQ en mono-thread, sinon MT-MASTER / MT-WORKER
+    inline const char* ThreadTag() {
+        #ifdef G4MULTITHREADED
+        return G4Threading::IsMasterThread() ? "[MT-MASTER]" : "[MT-WORKER]";
+        #else
+        return "[SEQ]";
+        #endif
+    }
+
+    constexpr char          kMagic[4]   = {'D', 'O', 'S', '1'};
+    constexpr std::uint32_t kVersion    = 2;
+    constexpr std::size_t   kHeaderSize = 4 + 4 + 3 * 4 + 6 * 8 + 3 * 8;
+    constexpr std::size_t   kRecordSize = 4 + 3 * 4;
+
+    // Écriture champ par champ : pas de padding de struct dans le fichier
+    template <typename T> inline void Put(char*& p, T v) { std::memcpy(p, &v, sizeof(T)); p += sizeof(T); }
+
+    // Nombre de voxels d'un axe : 2*half / pas arrondi à l'entier le plus proche (>= 1)
+    inline G4int NbVoxels(G4double half, G4double pitch) {
+        return std::max(1, static_cast<G4int>(std::lround(2. * half / pitch)));
+    }
+}
+
+// ==================== Configuration partagée ====================
+// Défaut : eau (r <= 10 mm, z = 65-68 mm) et conteneur PVC (r <= 11 mm, fond à 69 mm)
+G4bool        DoseMesh::fEnabled    = false;
+G4ThreeVector DoseMesh::fCenter     = G4ThreeVector(0., 0., 67.*mm);
+G4ThreeVector DoseMesh::fHalfSize   = G4ThreeVector(11.*mm, 11.*mm, 2.*mm);
+G4ThreeVector DoseMesh::fVoxelSize  = G4ThreeVector(0.5*mm, 0.5*mm, 0.25*mm);
+G4String      DoseMesh::fOutputBase = "dose_mesh";
+DoseMeshMessenger* DoseMesh::fMessenger = nullptr;
+
+void DoseMesh::Init()
+{
+    // Configuration commune à tous les threads : un seul messenger (master / SEQ)
+    if (G4Threading::IsMasterThread() && !fMessenger) fMessenger = new DoseMeshMessenger();
+}
+
+// ==================== Début / fin de run ====================
+void DoseMesh::BeginRun()
+{
+    fNx = fNy = fNz = 0;
+    fDirectory.clear();
+    Reset();
+    if (!fEnabled) return;
+
+    if (!(fVoxelSize.x() > 0. && fVoxelSize.y() > 0. && fVoxelSize.z() > 0.)) {
+        G4Exception("DoseMesh::BeginRun", "DOSE001", JustWarning,
+                    "Pas de voxel nul ou négatif : maillage de dose ignoré pour ce run.");
+        return;
+    }
+
+    const G4int nx = NbVoxels(fHalfSize.x(), fVoxelSize.x());
+    const G4int ny = NbVoxels(fHalfSize.y(), fVoxelSize.y());
+    const G4int nz = NbVoxels(fHalfSize.z(), fVoxelSize.z());
+    const std::uint64_t nVoxels = std::uint64_t(nx) * ny * nz;
+    if (nVoxels > kMaxVoxels) {
+        G4ExceptionDescription ed;
+        ed << nx << " x " << ny << " x " << nz << " voxels : plus de 2^32 voxels,"
+           << " maillage de dose ignoré pour ce run.";
+        G4Exception("DoseMesh::BeginRun", "DOSE001", JustWarning, ed);
+        return;
+    }
+
+    fNx = nx; fNy = ny; fNz = nz;
+    fPitch  = fVoxelSize;
+    fOrigin = fCenter - 0.5 * G4ThreeVector(nx * fPitch.x(), ny * fPitch.y(), nz * fPitch.z());
+    fNbx = (nx + kBlockEdge - 1) / kBlockEdge;
+    fNby = (ny + kBlockEdge - 1) / kBlockEdge;
+    fNbz = (nz + kBlockEdge - 1) / kBlockEdge;
+    fDirectory.assign(std::size_t(fNbx) * fNby * fNbz, -1);
+
+    if (G4Threading::IsMasterThread()) {
+        G4cout << ThreadTag() << " [DOSE3D] Maillage " << nx << " x " << ny << " x " << nz
+               << " voxels de " << fPitch.x()/mm << " x " << fPitch.y()/mm << " x " << fPitch.z()/mm << " mm"
+               << " | x=[" << fOrigin.x()/mm << ", " << (fOrigin.x() + nx*fPitch.x())/mm << "]"
+               << " y=[" << fOrigin.y()/mm << ", " << (fOrigin.y() + ny*fPitch.y())/mm << "]"
+               << " z=[" << fOrigin.z()/mm << ", " << (fOrigin.z() + nz*fPitch.z())/mm << "] mm"
+               << " | " << fDirectory.size() << " blocs de " << kBlockSize << " voxels"
+               << " -> " << fOutputBase << ".dose" << G4endl;
+    }
+}
+
+void DoseMesh::EndRun()
+{
+    if (fNx == 0) return;
+
+    // [FIX] Rejeu (source 4) : normalisation par primaire équivalent de l'étape 1,
+    //       pas par histoire du fichier ; la variance reste celle des histoires
+    const G4double nEvents     = static_cast<G4double>(fHistories);
+    const G4double equivalents = PhaseSpace::HasInputs() ? PhaseSpace::GetEquivalentPrimaries() : 0.;
+    const G4double nHist       = (equivalents > 0.) ? equivalents : nEvents;
+    const G4double volume  = fPitch.x() * fPitch.y() * fPitch.z();
+
+    // Matériau au centre des voxels touchés : navigateur dédié (ne perturbe pas le suivi)
+    G4Navigator nav;
+    nav.SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                           ->GetNavigatorForTracking()->GetWorldVolume());
+
+    const G4String name = fOutputBase + ".dose";
+    std::ofstream out(name, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        G4ExceptionDescription ed;
+        ed << "Impossible d'ouvrir " << name << " en écriture : maillage de dose perdu.";
+        G4Exception("DoseMesh::EndRun", "DOSE002", JustWarning, ed);
+        return;
+    }
+    char header[kHeaderSize] = {};
+    out.write(header, kHeaderSize);   // réécrit après les enregistrements
+
+    std::uint64_t records = 0;
+    G4double maxDose = 0., maxRel = 0.;
+    std::uint32_t maxIndex = 0;
+    char buf[kRecordSize];
+    for (const auto& b : fBlocks) {
+        const G4int bx = b.id % fNbx;
+        const G4int by = (b.id / fNbx) % fNby;
+        const G4int bz = b.id / (fNbx * fNby);
+        for (G4int k = 0; k < kBlockSize; ++k) {
+            if (!(b.sum[k] > 0.)) continue;
+            const G4int ix = bx * kBlockEdge + k % kBlockEdge;
+            const G4int iy = by * kBlockEdge + (k / kBlockEdge) % kBlockEdge;
+            const G4int iz = bz * kBlockEdge + k / (kBlockEdge * kBlockEdge);
+
+            // Moyenne par histoire et variance de la moyenne, ramenées à un primaire
+            const G4double mean = b.sum[k] / nEvents;
+            const G4double var  = (fHistories > 1)
+                ? std::max(0., b.sum2[k] / nEvents - mean * mean) / (nEvents - 1.) : 0.;
+            const G4double eHist = b.sum[k] / nHist;
+            const G4double sHist = std::sqrt(var) * nEvents / nHist;
+
+            const G4ThreeVector centre = fOrigin + G4ThreeVector((ix + 0.5) * fPitch.x(),
+                                                                 (iy + 0.5) * fPitch.y(),
+                                                                 (iz + 0.5) * fPitch.z());
+            const G4VPhysicalVolume* pv = nav.LocateGlobalPointAndSetup(centre, nullptr, false, true);
+            const G4Material* mat = pv ? pv->GetLogicalVolume()->GetMaterial() : nullptr;
+            const G4double density = mat ? mat->GetDensity() : 0.;
+            const G4double toGy = (density > 0.) ? keV / (density * volume) / gray : 0.;
+
+            const std::uint32_t index = std::uint32_t(ix) + std::uint32_t(fNx) * (iy + std::uint32_t(fNy) * iz);
+            char* p = buf;
+            Put<std::uint32_t>(p, index);
+            Put<float>(p, static_cast<float>(eHist * toGy));
+            Put<float>(p, static_cast<float>(sHist * toGy));
+            Put<float>(p, static_cast<float>(density / (g/cm3)));
+            out.write(buf, kRecordSize);
+            ++records;
+
+            if (eHist * toGy > maxDose) {
+                maxDose = eHist * toGy;
+                maxRel = (eHist > 0.) ? sHist / eHist : 0.;
+                maxIndex = index;
+            }
+        }
+    }
+
+    char* p = header;
+    std::memcpy(p, kMagic, 4); p += 4;
+    Put<std::uint32_t>(p, kVersion);
+    Put<std::uint32_t>(p, std::uint32_t(fNx));
+    Put<std::uint32_t>(p, std::uint32_t(fNy));
+    Put<std::uint32_t>(p, std::uint32_t(fNz));
+    Put<double>(p, fOrigin.x() / mm);
+    Put<double>(p, fOrigin.y() / mm);
+    Put<double>(p, fOrigin.z() / mm);
+    Put<double>(p, fPitch.x() / mm);
+    Put<double>(p, fPitch.y() / mm);
+    Put<double>(p, fPitch.z() / mm);
+    Put<std::uint64_t>(p, fHistories);
+    Put<std::uint64_t>(p, static_cast<std::uint64_t>(std::llround(nHist)));
+    Put<std::uint64_t>(p, records);
+    out.seekp(0);
+    out.write(header, kHeaderSize);
+    out.close();
+
+    const std::uint64_t nVoxels = std::uint64_t(fNx) * fNy * fNz;
+    const G4double memMB = (fBlocks.size() * sizeof(Block) + fDirectory.size() * sizeof(G4int)) / 1048576.;
+    G4cout << ThreadTag() << " [DOSE3D][SUMMARY] " << name << " : " << records << " voxels touchés sur "
+           << nVoxels << " | " << fBlocks.size() << "/" << fDirectory.size() << " blocs alloués ("
+           << memMB << " Mo) | " << fHistories << " histoires, " << nHist
+           << ((equivalents > 0.) ? " primaires équivalents de l'étape 1" : " primaires") << G4endl;
+    if (records > 0) {
+        G4cout << ThreadTag() << " [DOSE3D][SUMMARY] dose max = " << maxDose * 1.e12
+               << " pGy par primaire (+/- " << 100. * maxRel << " %) au voxel "
+               << maxIndex % fNx << ", " << (maxIndex / fNx) % fNy << ", " << maxIndex / (fNx * fNy) << G4endl;
+    }
+}
+
+// ==================== Remplissage ====================
+std::uint32_t DoseMesh::BlockSlot(std::uint32_t id)
+{
+    G4int& slot = fDirectory[id];
+    if (slot < 0) {
+        slot = static_cast<G4int>(fBlocks.size());
+        fBlocks.emplace_back();
+        fBlocks.back().id = id;
+    }
+    return static_cast<std::uint32_t>(slot);
+}
+
+void DoseMesh::Deposit(const G4ThreeVector& pos, G4double edep_keV, G4int slot)
+{
+    if (fNx == 0) return;
+
+    const G4double fx = (pos.x() - fOrigin.x()) / fPitch.x();
+    const G4double fy = (pos.y() - fOrigin.y()) / fPitch.y();
+    const G4double fz = (pos.z() - fOrigin.z()) / fPitch.z();
+    if (fx < 0. || fy < 0. || fz < 0. || fx >= fNx || fy >= fNy || fz >= fNz) return;
+
+    const G4int ix = static_cast<G4int>(fx);
+    const G4int iy = static_cast<G4int>(fy);
+    const G4int iz = static_cast<G4int>(fz);
+
+    const std::uint32_t id = std::uint32_t(ix / kBlockEdge)
+        + std::uint32_t(fNbx) * (iy / kBlockEdge + std::uint32_t(fNby) * (iz / kBlockEdge));
+    const std::uint32_t slot = BlockSlot(id);
+    const std::uint32_t offset = ix % kBlockEdge + kBlockEdge * (iy % kBlockEdge + kBlockEdge * (iz % kBlockEdge));
+
+    // Piles LIFO : un primaire et ses secondaires sont suivis d'un bloc,
+    // un changement de slot est rare dans l'événement
+    if (slot != fSlot) {
+        StageSlot();
+        fSlot = slot;
+    }
+    G4double& e = fBlocks[slot].event[offset];
+    if (e == 0.) fTouched.push_back({slot, offset});
+    e += edep_keV;
+}
+
+void DoseMesh::StageSlot()
+{
+    for (const auto& t : fTouched) {
+        G4double& e = fBlocks[t.block].event[t.offset];
+        fStaged.push_back({t.block, t.offset, fSlot, e});
+        e = 0.;
+    }
+    fTouched.clear();
+}
+
+void DoseMesh::EndEvent(G4int nSlots)
+{
+    if (fNx == 0) return;
+
+    if (fStaged.empty()) {
+        // Un seul primaire a déposé dans la boîte : cumul direct
+        for (const auto& t : fTouched) {
+            Block& b = fBlocks[t.block];
+            const G4double e = b.event[t.offset];
+            b.sum[t.offset]  += e;
+            b.sum2[t.offset] += e * e;
+            b.event[t.offset] = 0.;
+        }
+        fTouched.clear();
+    } else {
+        // Plusieurs primaires : e par couple (voxel, slot), un slot pouvant
+        // revenir après un autre (piles en attente, biaisage)
+        StageSlot();
+        std::sort(fStaged.begin(), fStaged.end(), [](const Staged& a, const Staged& b) {
+            if (a.block != b.block) return a.block < b.block;
+            if (a.offset != b.offset) return a.offset < b.offset;
+            return a.slot < b.slot;
+        });
+        for (std::size_t i = 0; i < fStaged.size();) {
+            const Staged& first = fStaged[i];
+            G4double e = 0.;
+            for (; i < fStaged.size() && fStaged[i].block == first.block && fStaged[i].offset == first.offset
+                   && fStaged[i].slot == first.slot; ++i) {
+                e += fStaged[i].e;
+            }
+            Block& b = fBlocks[first.block];
+            b.sum[first.offset]  += e;
+            b.sum2[first.offset] += e * e;
+        }
+        fStaged.clear();
+    }
+    fHistories += static_cast<std::uint64_t>(nSlots > 0 ? nSlots : 1);
+}
+
+// ==================== Interface G4VAccumulable ====================
+void DoseMesh::Merge(const G4VAccumulable& other)
+{
+    const auto& rhs = static_cast<const DoseMesh&>(other);
+    if (fNx == 0 || rhs.fNx == 0) return;
+
+    for (const auto& src : rhs.fBlocks) {
+        Block& dst = fBlocks[BlockSlot(src.id)];
+        for (G4int k = 0; k < kBlockSize; ++k) {
+            dst.sum[k]  += src.sum[k];
+            dst.sum2[k] += src.sum2[k];
+        }
+    }
+    fHistories += rhs.fHistories;
+}
+
+void DoseMesh::Reset()
+{
+    fBlocks.clear();
+    std::fill(fDirectory.begin(), fDirectory.end(), -1);
+    fTouched.clear();
+    fStaged.clear();
+    fSlot = 0;
+    fHistories = 0;
+}
+
+#if G4VERSION_NUMBER >= 1130
+void DoseMesh::Print(G4PrintOptions) const
+{
+    G4cout << "[ACC] " << GetName() << " : " << fBlocks.size() << " blocs alloués, "
+           << fHistories << " histoires" << G4endl;
+}
+#endif
@@ -0,0 +1,73 @@
+#include "DoseMeshMessenger.hh"
+#include "DoseMesh.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : le maillage est le même
+//  pour tous les threads, les commandes ne sont donc pas retransmises.
+DoseMeshMessenger::DoseMeshMessenger()
+{
+    fDir = new G4UIdirectory("/dosemesh/");
+    fDir->SetGuidance("Maillage 3D de dose (creux, par blocs) au-dessus du conteneur d'eau.");
+
+    fEnableCmd = new G4UIcmdWithABool("/dosemesh/enable", this);
+    fEnableCmd->SetGuidance("Active le maillage de dose (fichier <output>.dose en fin de run).");
+    fEnableCmd->SetParameterName("on", false);
+    fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEnableCmd->SetToBeBroadcasted(false);
+
+    fCenterCmd = new G4UIcmdWith3VectorAndUnit("/dosemesh/center", this);
+    fCenterCmd->SetGuidance("Centre de la boîte du maillage.");
+    fCenterCmd->SetParameterName("x", "y", "z", false);
+    fCenterCmd->SetDefaultUnit("mm");
+    fCenterCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fCenterCmd->SetToBeBroadcasted(false);
+
+    fHalfSizeCmd = new G4UIcmdWith3VectorAndUnit("/dosemesh/halfSize", this);
+    fHalfSizeCmd->SetGuidance("Demi-dimensions de la boîte du maillage.");
+    fHalfSizeCmd->SetParameterName("hx", "hy", "hz", false);
+    fHalfSizeCmd->SetDefaultUnit("mm");
+    fHalfSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fHalfSizeCmd->SetToBeBroadcasted(false);
+
+    fVoxelSizeCmd = new G4UIcmdWith3VectorAndUnit("/dosemesh/voxelSize", this);
+    fVoxelSizeCmd->SetGuidance("Pas des voxels (la boîte est arrondie à un nombre entier de voxels).");
+    fVoxelSizeCmd->SetParameterName("dx", "dy", "dz", false);
+    fVoxelSizeCmd->SetDefaultUnit("mm");
+    fVoxelSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fVoxelSizeCmd->SetToBeBroadcasted(false);
+
+    fOutputCmd = new G4UIcmdWithAString("/dosemesh/output", this);
+    fOutputCmd->SetGuidance("Nom de base du fichier de dose (<nom>.dose).");
+    fOutputCmd->SetParameterName("base", false);
+    fOutputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fOutputCmd->SetToBeBroadcasted(false);
+}
+
+DoseMeshMessenger::~DoseMeshMessenger()
+{
+    delete fEnableCmd;
+    delete fCenterCmd;
+    delete fHalfSizeCmd;
+    delete fVoxelSizeCmd;
+    delete fOutputCmd;
+    delete fDir;
+}
+
+void DoseMeshMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fEnableCmd) {
+        DoseMesh::SetEnabled(fEnableCmd->GetNewBoolValue(value));
+    } else if (command == fCenterCmd) {
+        DoseMesh::SetCenter(fCenterCmd->GetNew3VectorValue(value));
+    } else if (command == fHalfSizeCmd) {
+        DoseMesh::SetHalfSize(fHalfSizeCmd->GetNew3VectorValue(value));
+    } else if (command == fVoxelSizeCmd) {
+        DoseMesh::SetVoxelSize(fVoxelSizeCmd->GetNew3VectorValue(value));
+    } else if (command == fOutputCmd) {
+        DoseMesh::SetOutput(value);
+    }
+}
@@ -17,6 +17,10 @@
 
 #include "SphereHit.hh"
 #include "RunAction.hh"
+#include "Diagnostics.hh"
+#include "StepTracer.hh"
+#include "RunLedger.hh"
+#include "PrimaryGeneratorAction.hh"
 
 
 //******************************************************************************************
@@ -33,7 +37,9 @@
 //  mais l'objet EventAction est prêt à être utilisé dans ActionInitialization.
 //
 
-EventAction::EventAction(){}
+EventAction::EventAction()
+: fTracer(StepTracer::Instance())   // instance du thread qui exécute les événements
+{}
 
 EventAction::~EventAction(){}
 
@@ -44,18 +50,22 @@ void EventAction::BeginOfEventAction(const G4Event*  event)
     // Réinitialisation pour chaque événement
     enteredCube = false;
     enteredSphere = false;
-    creatorProcess = "unknown";
+    creatorProcess = nullptr;
 
     fNbEntrantInBe = 0;
     fNbInteractedInBe = 0;
     fNbEntrantInWaterSphere = 0;
     fNbInteractedInWaterSphere = 0;
 
-    // Réinitialisation des énergies déposées dans les anneaux d'eau
-    for (G4int i = 0; i < kNbWaterRings; i++) {
-        fEdepRing[i] = 0.0;
-    }
-    fEdepTotalWater = 0.0;
+    // Réinitialisation des énergies déposées dans les anneaux d'eau :
+    // un score par primaire tiré dans l'événement
+    const auto* generator = static_cast<const PrimaryGeneratorAction*>(
+        G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+    const G4int nSlots = generator ? generator->GetNbPrimarySlots() : 1;
+    fScores.assign(nSlots > 0 ? nSlots : 1, PrimaryScore());
+
+    // [ADD] Suivi step par step : décision unique pour tout l'événement
+    fTracer->BeginEvent(event);
 
     // 🔍 Récupérer la particule primaire
     G4PrimaryVertex* primaryVertex = event->GetPrimaryVertex();
@@ -68,18 +78,18 @@ void EventAction::BeginOfEventAction(const G4Event*  event)
             G4ThreeVector mom = primary->GetMomentumDirection();
             G4double energy = primary->GetTotalEnergy();
 
-            if (fEventVerboseLevel == 1) {
+            if (Diag::Verbose(fEventVerboseLevel)) {
             G4cout << "[DEBUG BeginOfEventAction] Particule primaire = " << name << G4endl;
             G4cout << "[DEBUG BeginOfEventAction] Direction         = " << mom << G4endl;
             G4cout << "[DEBUG BeginOfEventAction] Énergie totale    = " << energy / keV << " keV" << G4endl;
             }
         } else {
-            if (fEventVerboseLevel == 1) {
+            if (Diag::Verbose(fEventVerboseLevel)) {
             G4cout << "[DEBUG BeginOfEventAction] Pas de particule primaire." << G4endl;
             }
         }
     } else {
-        if (fEventVerboseLevel == 1) {
+        if (Diag::Verbose(fEventVerboseLevel)) {
         G4cout << "[DEBUG BeginOfEventAction] Pas de vertex primaire." << G4endl;
         }
     }
@@ -90,27 +100,40 @@ void EventAction::BeginOfEventAction(const G4Event*  event)
 
 void EventAction::EndOfEventAction(const G4Event* event)
 {
-    if (fEventVerboseLevel == 1) {
+    if (Diag::Verbose(fEventVerboseLevel)) {
         G4cout << "[DEBUG EndOfEventAction] EndOfEventAction appelé pour EventID = "<<event->GetEventID()<<G4endl;
         G4cout << "[DEBUG EndOfEventAction] NbEntrantInBe = "<<fNbEntrantInBe<<G4endl;
         G4cout << "[DEBUG EndOfEventAction] NbInteractedInBe = "<<fNbInteractedInBe<<G4endl;}
 
+    // [ADD] Trajectoires effectivement stockées (selon /trajectories/mode)
+    if (const auto* trajectories = event->GetTrajectoryContainer()) {
+        RunLedger::Instance()->Add(Ledger::kTrajectoriesStored, static_cast<G4long>(trajectories->entries()));
+    }
+
     // Ntuples trackInfo (ID=1), SphereHits (ID=0), SphereStats (ID=2) supprimés
     // Histogrammes supprimés
 
+    // [ADD] Histoires du run : un primaire = une histoire, même groupé par événement
+    RunLedger::Instance()->Add(Ledger::kHistories, static_cast<G4long>(fScores.size()));
+
     if (fRunAction) {
         fRunAction->UpdateFromEvent(this);
         
-        // Transmettre l'énergie déposée dans les anneaux d'eau
-        fRunAction->AddEdepFromEvent(fEdepRing, fEdepTotalWater);
-        
-        // Vérifier si on doit remplir les histogrammes de dose (tous les 1000 événements)
-        fRunAction->CheckAndFillDoseHistograms(event->GetEventID());
+        // Transmettre l'énergie déposée dans les anneaux d'eau, primaire par primaire
+        // (sommes des carrés = variance par histoire, lots de 10000 histoires)
+        for (const auto& score : fScores) {
+            fRunAction->AddEdepFromEvent(score.edepRing, score.edepTotal);
+            fRunAction->AddKermaFromEvent(score.kermaRing);
+            fRunAction->CheckAndFillDoseHistograms(event->GetEventID());
+        }
+        fRunAction->FlushEventTransmission();
+        // Maillage 3D de dose : e et e² par primaire (une histoire) -> sommes du run
+        fRunAction->GetDoseMesh().EndEvent(static_cast<G4int>(fScores.size()));
     }
 
     auto runAction = static_cast<const RunAction*>(G4RunManager::GetRunManager()->GetUserRunAction());
     if (runAction) {
-        if (fEventVerboseLevel == 1) {
+        if (Diag::Verbose(fEventVerboseLevel)) {
             G4cout << "\n[DEBUG EndOfEventAction] [EndOfEventAction DEBUG] Compteurs globaux (fin event #" << G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID() << ") :" << G4endl;
             G4cout<<" [DEBUG EndOfEventAction ↪ fTotalEntrantInBe          = "<<runAction->GetTotalEntrantInBe()<<G4endl;
             G4cout<<" [DEBUG EndOfEventAction ↪ fTotalInteractedInBe       = "<<runAction->GetTotalInteractedInBe()<<G4endl;
@@ -121,6 +144,21 @@ void EventAction::EndOfEventAction(const G4Event* event)
     // SphereSD supprimé - plus d'accès à SphereHitsCollection
 }
 
+G4double EventAction::GetEdepRing(G4int ringIndex) const
+{
+    if (ringIndex < 0 || ringIndex >= kNbWaterRings) return 0.0;
+    G4double sum = 0.0;
+    for (const auto& score : fScores) sum += score.edepRing[ringIndex];
+    return sum;
+}
+
+G4double EventAction::GetEdepTotalWater() const
+{
+    G4double sum = 0.0;
+    for (const auto& score : fScores) sum += score.edepTotal;
+    return sum;
+}
+
 //  Méthode appelée par SteppingAction pour transmettre à EventAction
 //  les informations spécifiques au track primaire
 
@@ -131,10 +169,9 @@ void EventAction::SetTrackInfo(MyTrackInfo* info)
     enteredCube = info->HasEnteredCube();
     enteredSphere = info->HasEnteredSphere();
 
-    G4String p = info->GetCreatorProcess();
-    creatorProcess = (p.empty() ? "unknown" : p);
+    creatorProcess = &info->GetCreatorProcess();
 
-    if (fEventVerboseLevel == 1) {
-        G4cout<<"[DEBUG SetTrackInfo] ✅ Infos copiées : process="<<creatorProcess<<", cube="<<enteredCube<<", sphère="<<enteredSphere<<G4endl;}
+    if (Diag::Verbose(fEventVerboseLevel)) {
+        G4cout<<"[DEBUG SetTrackInfo] ✅ Infos copiées : process="<<*creatorProcess<<", cube="<<enteredCube<<", sphère="<<enteredSphere<<G4endl;}
 }
 
@@ -0,0 +1,55 @@
+#include "ImportanceMessenger.hh"
+#include "ImportanceWorld.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//  Messenger créé une seule fois (master / SEQ) avec le monde d'importance :
+//  les importances sont partagées par tous les threads et recopiées dans leur
+//  G4IStore au début du run suivant, les commandes ne sont donc pas retransmises.
+ImportanceMessenger::ImportanceMessenger()
+{
+    fDir = new G4UIdirectory("/importance/");
+    fDir->SetGuidance("Importances géométriques des tranches en z (splitting / roulette des gammas).");
+
+    fSlabCmd = new G4UIcommand("/importance/slab", this);
+    fSlabCmd->SetGuidance("Importance d'une tranche : /importance/slab <index> <valeur>.");
+    fSlabCmd->SetGuidance("Rapport I_suivante/I_courante > 1 : splitting ; < 1 : roulette russe.");
+    auto* indexPar = new G4UIparameter("index", 'i', false);
+    indexPar->SetParameterRange("index>=0");
+    fSlabCmd->SetParameter(indexPar);
+    auto* valuePar = new G4UIparameter("value", 'd', false);
+    valuePar->SetParameterRange("value>0.");
+    fSlabCmd->SetParameter(valuePar);
+    fSlabCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fSlabCmd->SetToBeBroadcasted(false);
+
+    fListCmd = new G4UIcmdWithoutParameter("/importance/list", this);
+    fListCmd->SetGuidance("Liste des tranches et de leurs importances.");
+    fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fListCmd->SetToBeBroadcasted(false);
+}
+
+ImportanceMessenger::~ImportanceMessenger()
+{
+    delete fSlabCmd;
+    delete fListCmd;
+    delete fDir;
+}
+
+void ImportanceMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fSlabCmd) {
+        std::istringstream is(value);
+        G4int index = -1;
+        G4double importance = 0.;
+        is >> index >> importance;
+        ImportanceWorld::SetImportance(index, importance);
+    } else if (command == fListCmd) {
+        ImportanceWorld::PrintImportances();
+    }
+}
@@ -0,0 +1,126 @@
+#include "ImportanceWorld.hh"
+#include "ImportanceMessenger.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4GeometryCell.hh"
+#include "G4IStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+namespace {
+    // Tranches en z le long du faisceau (cf. ImportanceWorld.hh)
+    struct SlabDef { const char* name; G4double zMin; G4double zMax; };
+    const SlabDef kSlabDefs[] = {
+        {"source", -60.00*mm,  1.90*mm},
+        {"cone",     1.90*mm, 16.95*mm},
+        {"plane1",  16.95*mm, 23.00*mm},
+        {"plane2",  23.00*mm, 33.00*mm},
+        {"plane3",  33.00*mm, 51.50*mm},
+        {"drift",   51.50*mm, 64.00*mm},
+        {"water",   64.00*mm, 72.00*mm},
+    };
+    constexpr G4int kNbSlabs = sizeof(kSlabDefs) / sizeof(kSlabDefs[0]);
+}
+
+// ==================== Configuration partagée ====================
+ImportanceWorld*      ImportanceWorld::fInstance = nullptr;
+std::vector<G4double> ImportanceWorld::fImportances(kNbSlabs, 1.);
+ImportanceMessenger*  ImportanceWorld::fMessenger = nullptr;
+
+ImportanceWorld::ImportanceWorld(const G4String& worldName)
+: G4VUserParallelWorld(worldName)
+{
+    // Un seul monde d'importance, créé dans main() (master)
+    fInstance = this;
+    if (!fMessenger) fMessenger = new ImportanceMessenger();
+}
+
+ImportanceWorld::~ImportanceWorld()
+{
+    if (fInstance == this) fInstance = nullptr;
+    delete fMessenger;
+    fMessenger = nullptr;
+}
+
+// Géométrie des tranches (master, une fois) : volumes sans matériau du monde parallèle
+void ImportanceWorld::Construct()
+{
+    fGhostWorld = GetWorld();
+    G4LogicalVolume* worldLV = fGhostWorld->GetLogicalVolume();
+
+    fSlabs.clear();
+    for (const auto& def : kSlabDefs) {
+        const G4double halfZ = 0.5 * (def.zMax - def.zMin);
+        auto* solid = new G4Box(G4String("solidImp_") + def.name,
+                                 DetectorConstruction::kEnveloppeHalfXY,
+                                 DetectorConstruction::kEnveloppeHalfXY, halfZ);
+        auto* logic = new G4LogicalVolume(solid, nullptr, G4String("logicImp_") + def.name);
+        fSlabs.push_back(new G4PVPlacement(nullptr, G4ThreeVector(0., 0., def.zMin + halfZ),
+                                           logic, G4String("physImp_") + def.name,
+                                           worldLV, false, 0, true));
+    }
+
+    G4cout << "[IMP] Monde parallèle '" << GetName() << "' : " << kNbSlabs << " tranches en z" << G4endl;
+}
+
+// Appelé sur chaque worker (et en SEQ) : G4IStore rempli avant le premier run
+void ImportanceWorld::ConstructSD()
+{
+    ApplyToStore();
+}
+
+void ImportanceWorld::ApplyToStore() const
+{
+    if (!fGhostWorld) return;
+    G4IStore* store = G4IStore::GetInstance(GetName());
+
+    const G4GeometryCell worldCell(*fGhostWorld, 0);
+    if (!store->IsKnown(worldCell)) store->AddImportanceGeometryCell(1., worldCell);
+
+    for (G4int i = 0; i < kNbSlabs; ++i) {
+        const G4GeometryCell cell(*fSlabs[i], 0);
+        if (store->IsKnown(cell)) store->ChangeImportance(fImportances[i], cell);
+        else                      store->AddImportanceGeometryCell(fImportances[i], cell);
+    }
+}
+
+G4int ImportanceWorld::GetNumberOfSlabs()
+{
+    return kNbSlabs;
+}
+
+G4bool ImportanceWorld::SetImportance(G4int slab, G4double importance)
+{
+    if (slab < 0 || slab >= kNbSlabs || !(importance > 0.)) {
+        G4cerr << "[IMP] tranche " << slab << " / importance " << importance
+               << " invalide (0 <= index < " << kNbSlabs << ", importance > 0) : ignoré." << G4endl;
+        return false;
+    }
+    fImportances[slab] = importance;
+    return true;
+}
+
+void ImportanceWorld::PrintImportances()
+{
+    G4cout << "[IMP] Importances des tranches :" << G4endl;
+    for (G4int i = 0; i < kNbSlabs; ++i) {
+        G4cout << "  " << i << " " << kSlabDefs[i].name
+               << " z=[" << kSlabDefs[i].zMin/mm << ", " << kSlabDefs[i].zMax/mm << "] mm"
+               << " I=" << fImportances[i] << G4endl;
+    }
+}
+
+void ImportanceWorld::BeginRun()
+{
+    if (!fInstance) return;
+
+    // Chaque thread qui transporte des particules (worker MT, ou SEQ) met à jour
+    // SON G4IStore ; les BeginOfRunAction des workers suivent celui du master.
+    if (!G4Threading::IsMultithreadedApplication() || G4Threading::IsWorkerThread()) {
+        fInstance->ApplyToStore();
+    }
+    if (G4Threading::IsMasterThread()) PrintImportances();
+}
@@ -1,11 +1,15 @@
 #include "MyTrackInfo.hh"
 
-MyTrackInfo::MyTrackInfo()
+G4ThreadLocal G4Allocator<MyTrackInfo>* MyTrackInfoAllocator = nullptr;
+
+MyTrackInfo::MyTrackInfo(const G4VProcess* creator)
 : G4VUserTrackInformation(),
-  enteredCube(false), enteredSphere(false), creatorProcess("unknown"),
-  fComptonInCone(false), fNComptonInCone(0),
-  fLastComptonPos(0., 0., 0.), fLastComptonEkin(0.)
+  fCreatorProcess(creator),
+  fNComptonInCone(0),
+  fLastComptonPos(0., 0., 0.), fLastComptonEkin(0.), fLastComptonWeight(1.),
+  fPrimarySlot(0),
+  fEnteredCube(false), fEnteredSphere(false),
+  fComptonInCone(false), fTraced(false), fBiasClone(false), fStoppedAtPsf(false)
 {}
 
 MyTrackInfo::~MyTrackInfo() {}
-
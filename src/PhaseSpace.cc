@@ -0,0 +1,317 @@
+#include "PhaseSpace.hh"
+#include "PhaseSpaceMessenger.hh"
+#include "RunLedger.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Run.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // [ADD] Helper de logs : SEQ en mono-thread, sinon MT-MASTER / MT-WORKER
+    inline const char* ThreadTag() {
+        #ifdef G4MULTITHREADED
+        return G4Threading::IsMasterThread() ? "[MT-MASTER]" : "[MT-WORKER]";
+        #else
+        return "[SEQ]";
+        #endif
+    }
+
+    G4Mutex gReadMutex = G4MUTEX_INITIALIZER;
+
+    constexpr char          kMagic[4]   = {'P', 'S', 'F', '1'};
+    constexpr std::uint32_t kVersion    = 1;
+    constexpr std::size_t   kHeaderSize = 4 + 4 + 8 + 3 * 8;
+    constexpr std::size_t   kRecordSize = 4 + 1 + 7 * 4;
+
+    // Lecture / écriture champ par champ : pas de padding de struct dans le fichier
+    template <typename T> inline void Put(char*& p, T v) { std::memcpy(p, &v, sizeof(T)); p += sizeof(T); }
+    template <typename T> inline T Get(const char*& p) { T v; std::memcpy(&v, p, sizeof(T)); p += sizeof(T); return v; }
+
+    void WriteHeader(std::ofstream& out, G4double planeZ,
+                     std::uint64_t primaries, std::uint64_t histories, std::uint64_t records)
+    {
+        char buf[kHeaderSize];
+        char* p = buf;
+        std::memcpy(p, kMagic, 4); p += 4;
+        Put<std::uint32_t>(p, kVersion);
+        Put<double>(p, planeZ / mm);
+        Put<std::uint64_t>(p, primaries);
+        Put<std::uint64_t>(p, histories);
+        Put<std::uint64_t>(p, records);
+        out.seekp(0);
+        out.write(buf, kHeaderSize);
+    }
+} // namespace
+
+// ==================== Configuration partagée ====================
+G4bool                PhaseSpace::fWrite      = false;
+G4String              PhaseSpace::fOutputBase = "phasespace";
+G4double              PhaseSpace::fPlaneZ     = 1.85*mm;   // entre la fenêtre Be et le cône (1.90 mm)
+std::vector<G4String> PhaseSpace::fInputs;
+G4int                 PhaseSpace::fReuse      = 1;
+G4bool                PhaseSpace::fRotate     = true;
+G4bool                PhaseSpace::fRecycle    = false;
+PhaseSpaceMessenger*  PhaseSpace::fMessenger  = nullptr;
+
+G4ThreadLocal PhaseSpace::Writer* PhaseSpace::fWriter    = nullptr;
+G4ThreadLocal G4bool              PhaseSpace::fReplaying = false;
+
+std::ifstream         PhaseSpace::fIn;
+std::size_t           PhaseSpace::fInputIndex     = 0;
+std::uint64_t         PhaseSpace::fRecordsLeft    = 0;
+G4double              PhaseSpace::fInputPlaneZ    = 0.;
+G4bool                PhaseSpace::fHasPending     = false;
+PhaseSpace::Record    PhaseSpace::fPending;
+std::uint64_t         PhaseSpace::fInputPrimaries = 0;
+std::uint64_t         PhaseSpace::fInputHistories = 0;
+std::uint64_t         PhaseSpace::fHistoriesRead  = 0;
+std::uint64_t         PhaseSpace::fPasses         = 0;
+
+void PhaseSpace::Init()
+{
+    // Configuration commune à tous les threads : un seul messenger (master / SEQ)
+    if (G4Threading::IsMasterThread() && !fMessenger) fMessenger = new PhaseSpaceMessenger();
+}
+
+std::uint8_t PhaseSpace::TypeOf(const G4String& particleName, G4bool& known)
+{
+    known = true;
+    if (particleName == "gamma") return kGamma;
+    if (particleName == "e-")    return kElectron;
+    if (particleName == "e+")    return kPositron;
+    known = false;
+    return kNbTypes;
+}
+
+const char* PhaseSpace::ParticleName(std::uint8_t type)
+{
+    switch (type) {
+        case kGamma:    return "gamma";
+        case kElectron: return "e-";
+        case kPositron: return "e+";
+        default:        return "";
+    }
+}
+
+// ==================== Début / fin de run ====================
+void PhaseSpace::BeginRun()
+{
+    // ----- Écriture : un fichier par thread qui transporte (worker MT ou SEQ) -----
+    const G4bool tracks = !G4Threading::IsMultithreadedApplication() || G4Threading::IsWorkerThread();
+    if (fWrite && tracks) {
+        if (!fWriter) fWriter = new Writer();
+        fWriter->name = fOutputBase;
+        if (G4Threading::IsWorkerThread()) fWriter->name += "_t" + std::to_string(G4Threading::G4GetThreadId());
+        fWriter->name += ".psf";
+        fWriter->lastEventID = -1;
+        fWriter->lastSlot = -1;
+        fWriter->histories = 0;
+        fWriter->records = 0;
+        fWriter->file.open(fWriter->name, std::ios::binary | std::ios::trunc);
+        if (!fWriter->file) {
+            G4ExceptionDescription ed;
+            ed << "Impossible d'ouvrir " << fWriter->name << " en écriture.";
+            G4Exception("PhaseSpace::BeginRun", "PSF001", FatalException, ed);
+        }
+        WriteHeader(fWriter->file, fPlaneZ, 0, 0, 0);   // réécrit en fin de run
+    }
+
+    // ----- Lecture : état partagé, (ré)initialisé par le master avant les workers -----
+    if (!G4Threading::IsMasterThread()) return;
+
+    fIn.close();
+    fInputIndex = 0;
+    fRecordsLeft = 0;
+    fHasPending = false;
+    fInputPrimaries = 0;
+    fInputHistories = 0;
+    fHistoriesRead = 0;
+    fPasses = 0;
+
+    if (fWrite) {
+        G4cout << ThreadTag() << " [PSF] Écriture de l'espace des phases au plan z = "
+               << fPlaneZ/mm << " mm -> " << fOutputBase << "[_t<N>].psf"
+               << " (particules arrêtées au plan)" << G4endl;
+    }
+    if (fInputs.empty()) return;
+
+    // Normalisation : somme des primaires de l'étape 1 sur tous les fichiers
+    for (const auto& name : fInputs) {
+        std::ifstream in(name, std::ios::binary);
+        char buf[kHeaderSize];
+        if (!in.read(buf, kHeaderSize) || std::memcmp(buf, kMagic, 4) != 0) {
+            G4ExceptionDescription ed;
+            ed << name << " n'est pas un fichier d'espace des phases PSF1 lisible.";
+            G4Exception("PhaseSpace::BeginRun", "PSF002", FatalException, ed);
+            return;
+        }
+        const char* p = buf + 4;
+        const auto version   = Get<std::uint32_t>(p);
+        const auto planeZ    = Get<double>(p) * mm;
+        const auto primaries = Get<std::uint64_t>(p);
+        const auto histories = Get<std::uint64_t>(p);
+        const auto records   = Get<std::uint64_t>(p);
+        if (version != kVersion) {
+            G4ExceptionDescription ed;
+            ed << name << " : version " << version << " non supportée (attendu " << kVersion << ").";
+            G4Exception("PhaseSpace::BeginRun", "PSF003", FatalException, ed);
+        }
+        if (std::abs(planeZ - fPlaneZ) > 1.*um) {
+            G4ExceptionDescription ed;
+            ed << name << " a été écrit au plan z = " << planeZ/mm << " mm, /phasespace/planeZ = "
+               << fPlaneZ/mm << " mm : le rejet des retours vers l'amont utilise ce dernier.";
+            G4Exception("PhaseSpace::BeginRun", "PSF004", JustWarning, ed);
+        }
+        fInputPrimaries += primaries;
+        fInputHistories += histories;
+        G4cout << ThreadTag() << " [PSF] Entrée " << name << " : " << primaries << " primaires, "
+               << histories << " histoires, " << records << " particules" << G4endl;
+    }
+    G4cout << ThreadTag() << " [PSF] Rejeu : réutilisation x" << fReuse
+           << (fRotate ? ", rotation azimutale aléatoire" : ", sans rotation")
+           << (fRecycle ? ", recyclage en fin de fichiers" : "") << G4endl;
+
+    OpenInput(0);
+}
+
+void PhaseSpace::EndRun(const G4Run* /*run*/)
+{
+    if (fWriter && fWriter->file.is_open()) {
+        // Primaires = histoires du thread (événements x primaires par événement)
+        const std::uint64_t primaries = RunLedger::Instance()->Get(Ledger::kHistories);
+        WriteHeader(fWriter->file, fPlaneZ, primaries, fWriter->histories, fWriter->records);
+        fWriter->file.close();
+        G4cout << ThreadTag() << " [PSF] " << fWriter->name << " : " << primaries << " primaires, "
+               << fWriter->histories << " histoires, " << fWriter->records << " particules" << G4endl;
+    }
+
+    if (!G4Threading::IsMasterThread() || fInputs.empty()) return;
+
+    G4cout << ThreadTag() << " [PSF][SUMMARY] histoires lues=" << fHistoriesRead
+           << " (passages complets=" << fPasses << ")"
+           << " | primaires équivalentes de l'étape 1 ~ " << GetEquivalentPrimaries()
+           << " | réutilisation x" << fReuse << G4endl;
+    // [FIX] Hypothèse des incertitudes du run : une histoire lue (avec ses
+    //       rejeux) = une histoire indépendante
+    G4cout << ThreadTag() << " [PSF] Incertitudes : histoires du fichier supposées indépendantes,"
+           << " variance propre à l'espace des phases non incluse" << G4endl;
+    if (fPasses > 0) {
+        G4cout << ThreadTag() << " [PSF][WARN] Fichiers recyclés " << fPasses
+               << " fois : les histoires rejouées plusieurs fois sont corrélées,"
+               << " sigma sous-estimé et FOM surestimé" << G4endl;
+    }
+    fIn.close();
+}
+
+// ==================== Étape 1 : écriture ====================
+void PhaseSpace::Write(G4int eventID, G4int slot, const Record& rec)
+{
+    if (!fWriter || !fWriter->file.is_open()) return;
+
+    // Numéro d'histoire local au fichier : incrémenté à chaque nouveau primaire
+    // (nouvel événement, ou primaire suivant d'un événement multi-photons ; les
+    //  descendants d'un primaire sont suivis avant le primaire suivant)
+    if (eventID != fWriter->lastEventID || slot != fWriter->lastSlot) {
+        fWriter->lastEventID = eventID;
+        fWriter->lastSlot = slot;
+        ++fWriter->histories;
+    }
+
+    char buf[kRecordSize];
+    char* p = buf;
+    Put<std::uint32_t>(p, static_cast<std::uint32_t>(fWriter->histories - 1));
+    Put<std::uint8_t>(p, rec.type);
+    Put<float>(p, static_cast<float>(rec.position.x() / mm));
+    Put<float>(p, static_cast<float>(rec.position.y() / mm));
+    Put<float>(p, static_cast<float>(rec.direction.x()));
+    Put<float>(p, static_cast<float>(rec.direction.y()));
+    Put<float>(p, static_cast<float>(rec.direction.z()));
+    Put<float>(p, static_cast<float>(rec.ekin / keV));
+    Put<float>(p, static_cast<float>(rec.weight));
+    fWriter->file.write(buf, kRecordSize);
+    ++fWriter->records;
+}
+
+// ==================== Étape 2 : lecture ====================
+G4bool PhaseSpace::OpenInput(std::size_t index)
+{
+    // Appelé sous verrou (ou par le master avant le démarrage des workers)
+    fIn.close();
+    fIn.clear();
+    fHasPending = false;
+    fRecordsLeft = 0;
+    for (fInputIndex = index; fInputIndex < fInputs.size(); ++fInputIndex) {
+        fIn.open(fInputs[fInputIndex], std::ios::binary);
+        char buf[kHeaderSize];
+        if (!fIn.read(buf, kHeaderSize)) { fIn.close(); fIn.clear(); continue; }
+        const char* p = buf + 8;
+        fInputPlaneZ = Get<double>(p) * mm;
+        p += 2 * 8;
+        fRecordsLeft = Get<std::uint64_t>(p);
+        if (fRecordsLeft > 0) return true;
+        fIn.close();
+        fIn.clear();
+    }
+    return false;
+}
+
+G4bool PhaseSpace::NextHistory(std::vector<Record>& history)
+{
+    history.clear();
+    G4AutoLock lock(&gReadMutex);
+
+    auto readOne = [](Record& rec) -> G4bool {
+        while (fRecordsLeft == 0) {
+            if (fInputIndex + 1 < fInputs.size()) {
+                if (OpenInput(fInputIndex + 1)) break;
+            }
+            // Fin de la liste : recyclage éventuel depuis le premier fichier
+            if (!fRecycle || !OpenInput(0)) return false;
+            ++fPasses;
+        }
+        char buf[kRecordSize];
+        if (!fIn.read(buf, kRecordSize)) { fRecordsLeft = 0; return false; }
+        --fRecordsLeft;
+        const char* p = buf;
+        rec.history = Get<std::uint32_t>(p);
+        rec.type    = Get<std::uint8_t>(p);
+        const G4double x = Get<float>(p) * mm;
+        const G4double y = Get<float>(p) * mm;
+        rec.position.set(x, y, fInputPlaneZ);
+        const G4double ux = Get<float>(p);
+        const G4double uy = Get<float>(p);
+        const G4double uz = Get<float>(p);
+        rec.direction = G4ThreeVector(ux, uy, uz).unit();   // renormalisée (float32)
+        rec.ekin   = Get<float>(p) * keV;
+        rec.weight = Get<float>(p);
+        return true;
+    };
+
+    // Premier enregistrement : celui mis de côté à l'appel précédent, sinon le suivant
+    Record rec;
+    if (fHasPending) {
+        rec = fPending;
+        fHasPending = false;
+    } else if (!readOne(rec)) {
+        return false;
+    }
+    history.push_back(rec);
+
+    // Enregistrements suivants du même numéro d'histoire (et du même fichier)
+    const std::size_t file = fInputIndex;
+    while (fRecordsLeft > 0) {
+        if (!readOne(rec)) break;
+        if (fInputIndex != file || rec.history != history.front().history) {
+            fPending = rec;
+            fHasPending = true;
+            break;
+        }
+        history.push_back(rec);
+    }
+    ++fHistoriesRead;
+    return true;
+}
@@ -0,0 +1,101 @@
+#include "PhaseSpaceMessenger.hh"
+#include "PhaseSpace.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : la configuration est lue par
+//  tous les threads au début du run, les commandes ne sont donc pas retransmises.
+PhaseSpaceMessenger::PhaseSpaceMessenger()
+{
+    fDir = new G4UIdirectory("/phasespace/");
+    fDir->SetGuidance("Espace des phases au plan situé après la fenêtre Be (écriture / rejeu).");
+
+    fWriteCmd = new G4UIcmdWithABool("/phasespace/write", this);
+    fWriteCmd->SetGuidance("Enregistre les particules qui traversent le plan vers +z, puis les arrête.");
+    fWriteCmd->SetParameterName("on", false);
+    fWriteCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fWriteCmd->SetToBeBroadcasted(false);
+
+    fOutputCmd = new G4UIcmdWithAString("/phasespace/output", this);
+    fOutputCmd->SetGuidance("Nom de base des fichiers écrits : <nom>.psf (SEQ) ou <nom>_t<N>.psf (MT).");
+    fOutputCmd->SetParameterName("base", false);
+    fOutputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fOutputCmd->SetToBeBroadcasted(false);
+
+    fPlaneZCmd = new G4UIcmdWithADoubleAndUnit("/phasespace/planeZ", this);
+    fPlaneZCmd->SetGuidance("Position z du plan (défaut 1.85 mm : après la fenêtre Be, avant le cône).");
+    fPlaneZCmd->SetParameterName("z", false);
+    fPlaneZCmd->SetDefaultUnit("mm");
+    fPlaneZCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fPlaneZCmd->SetToBeBroadcasted(false);
+
+    fAddInputCmd = new G4UIcmdWithAString("/phasespace/addInput", this);
+    fAddInputCmd->SetGuidance("Ajoute un fichier .psf à rejouer (/primariesgenerator/selectsource 4).");
+    fAddInputCmd->SetParameterName("file", false);
+    fAddInputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fAddInputCmd->SetToBeBroadcasted(false);
+
+    fClearInputsCmd = new G4UIcmdWithoutParameter("/phasespace/clearInputs", this);
+    fClearInputsCmd->SetGuidance("Vide la liste des fichiers à rejouer.");
+    fClearInputsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fClearInputsCmd->SetToBeBroadcasted(false);
+
+    fReuseCmd = new G4UIcmdWithAnInteger("/phasespace/reuse", this);
+    fReuseCmd->SetGuidance("Nombre de rejeux de chaque histoire (poids divisé d'autant).");
+    fReuseCmd->SetGuidance("Rejeux émis dans le même primaire : une seule histoire statistique.");
+    fReuseCmd->SetParameterName("n", false);
+    fReuseCmd->SetRange("n>0");
+    fReuseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fReuseCmd->SetToBeBroadcasted(false);
+
+    fRotateCmd = new G4UIcmdWithABool("/phasespace/rotate", this);
+    fRotateCmd->SetGuidance("Rotation azimutale aléatoire autour de z à chaque rejeu (défaut true).");
+    fRotateCmd->SetParameterName("on", false);
+    fRotateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRotateCmd->SetToBeBroadcasted(false);
+
+    fRecycleCmd = new G4UIcmdWithABool("/phasespace/recycle", this);
+    fRecycleCmd->SetGuidance("Reprend au premier fichier quand tous ont été lus (sinon le run est arrêté).");
+    fRecycleCmd->SetParameterName("on", false);
+    fRecycleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRecycleCmd->SetToBeBroadcasted(false);
+}
+
+PhaseSpaceMessenger::~PhaseSpaceMessenger()
+{
+    delete fWriteCmd;
+    delete fOutputCmd;
+    delete fPlaneZCmd;
+    delete fAddInputCmd;
+    delete fClearInputsCmd;
+    delete fReuseCmd;
+    delete fRotateCmd;
+    delete fRecycleCmd;
+    delete fDir;
+}
+
+void PhaseSpaceMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fWriteCmd) {
+        PhaseSpace::SetWrite(fWriteCmd->GetNewBoolValue(value));
+    } else if (command == fOutputCmd) {
+        PhaseSpace::SetOutput(value);
+    } else if (command == fPlaneZCmd) {
+        PhaseSpace::SetPlaneZ(fPlaneZCmd->GetNewDoubleValue(value));
+    } else if (command == fAddInputCmd) {
+        PhaseSpace::AddInput(value);
+    } else if (command == fClearInputsCmd) {
+        PhaseSpace::ClearInputs();
+    } else if (command == fReuseCmd) {
+        PhaseSpace::SetReuse(fReuseCmd->GetNewIntValue(value));
+    } else if (command == fRotateCmd) {
+        PhaseSpace::SetRotate(fRotateCmd->GetNewBoolValue(value));
+    } else if (command == fRecycleCmd) {
+        PhaseSpace::SetRecycle(fRecycleCmd->GetNewBoolValue(value));
+    }
+}
@@ -0,0 +1,134 @@
+#include "PlaneTallies.hh"
+#include "PlaneTalliesMessenger.hh"
+#include "AnalysisManagerSetup.hh"
+#include "MyTrackInfo.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4Threading.hh"
+#include "G4Track.hh"
+
+#include <cmath>
+#include <initializer_list>
+
+namespace {
+    // Binning commun : 0.1 keV jusqu'à 60 keV (bornes de SpecSD), 1 % du demi-côté en x, y, r
+    constexpr G4int    kNbEBins = 600;
+    constexpr G4double kEMax_keV = 60.;
+    constexpr G4int    kNbXYBins = 100;
+    constexpr G4int    kNbRBins = 100;
+
+    struct PlaneSpec {
+        const char* prefix;
+        const char* title;
+        G4double    halfXY_mm;   // demi-côté du plan (rayon externe pour les couronnes)
+    };
+
+    // Même ordre que PlaneTallies::Plane
+    constexpr PlaneSpec kPlanes[PlaneTallies::kNbPlanes] = {
+        {"SP1", "ScorePlane (z=18 mm)",  50.},
+        {"SP2", "ScorePlane2 (z=28 mm)", 50.},
+        {"SP3", "ScorePlane3 (z=38 mm)", 50.},
+        {"WR",  "Couronnes d'eau",       10.},
+        {"SP5", "ScorePlane5 (z=70 mm)", 50.}
+    };
+
+    G4String Name(G4int p, const char* suffix)  { return G4String(kPlanes[p].prefix) + suffix; }
+    G4String Title(G4int p, const char* what)   { return G4String(kPlanes[p].title) + " : " + what; }
+}
+
+// ==================== Configuration partagée ====================
+G4int PlaneTallies::fFirstH1[PlaneTallies::kNbPlanes] = {-1, -1, -1, -1, -1};
+G4int PlaneTallies::fH2[PlaneTallies::kNbPlanes]      = {-1, -1, -1, -1, -1};
+G4int PlaneTallies::fMode = PlaneTallies::kNtuple;
+PlaneTalliesMessenger* PlaneTallies::fMessenger = nullptr;
+
+void PlaneTallies::Init()
+{
+    // Mode commun à tous les threads : messenger unique (master / SEQ)
+    if (!G4Threading::IsMasterThread() || fMessenger) return;
+    fMessenger = new PlaneTalliesMessenger();
+}
+
+const char* PlaneTallies::ModeName(G4int mode)
+{
+    switch (mode) {
+        case kNtuple:  return "ntuple";
+        case kTallies: return "tallies";
+        case kBoth:    return "both";
+        default:       return "?";
+    }
+}
+
+// ==================== Réservation ====================
+void PlaneTallies::Book()
+{
+    auto* man = G4AnalysisManager::Instance();
+
+    for (G4int p = 0; p < kNbPlanes; ++p) {
+        const G4double h = kPlanes[p].halfXY_mm;
+
+        fFirstH1[p] = man->CreateH1(Name(p, "_E"),
+            Title(p, "énergie;E (keV);Poids"), kNbEBins, 0., kEMax_keV);
+        man->CreateH1(Name(p, "_E_prim"),
+            Title(p, "énergie des primaires;E (keV);Poids"), kNbEBins, 0., kEMax_keV);
+        man->CreateH1(Name(p, "_E_sec"),
+            Title(p, "énergie des secondaires;E (keV);Poids"), kNbEBins, 0., kEMax_keV);
+        man->CreateH1(Name(p, "_E_compton"),
+            Title(p, "primaires redirigés par Compton (cône);E (keV);Poids"), kNbEBins, 0., kEMax_keV);
+        man->CreateH1(Name(p, "_r"),
+            Title(p, "rayon;r (mm);Poids"), kNbRBins, 0., h);
+
+        fH2[p] = man->CreateH2(Name(p, "_xy"),
+            Title(p, "carte x-y;x (mm);y (mm)"), kNbXYBins, -h, h, kNbXYBins, -h, h);
+    }
+}
+
+// ==================== Début de run ====================
+void PlaneTallies::BeginRun()
+{
+    auto* man = G4AnalysisManager::Instance();
+
+    // Objets inactifs : ni écrits ni fusionnés (G4AnalysisManager::SetActivation(true))
+    const G4bool tallies = FillTallies();
+    for (G4int p = 0; p < kNbPlanes; ++p) {
+        if (fFirstH1[p] < 0) continue;
+        for (G4int k = 0; k < kNbH1; ++k) man->SetH1Activation(fFirstH1[p] + k, tallies);
+        man->SetH2Activation(fH2[p], tallies);
+    }
+
+    const G4bool rows = WriteRows();
+    for (const G4int id : {GetPlanePassageNtupleId(), GetScorePlane2NtupleId(), GetScorePlane3NtupleId(),
+                           GetScorePlane4NtupleId(), GetScorePlane5NtupleId()}) {
+        if (id >= 0) man->SetNtupleActivation(id, rows);
+    }
+
+    if (G4Threading::IsMasterThread()) {
+        G4cout << "[TALLY] Sortie des plans de comptage : " << ModeName(fMode)
+               << " | ntuples *_passages " << (rows ? "remplis" : "désactivés")
+               << " | histogrammes binnés " << (tallies ? "remplis" : "désactivés") << G4endl;
+    }
+}
+
+// ==================== Remplissage ====================
+void PlaneTallies::Fill(G4int plane, const G4Track* track,
+                        G4double x_mm, G4double y_mm, G4double ekin_keV)
+{
+    const G4int h = fFirstH1[plane];
+    if (h < 0) return;
+
+    auto* man = G4AnalysisManager::Instance();
+    const G4double w = track->GetWeight();
+
+    man->FillH1(h + kE, ekin_keV, w);
+    // [FIX] Même règle que la colonne is_secondary des ntuples : les clones du
+    //       biais forced collision (option -f) restent des primaires
+    if (MyTrackInfo::IsPrimary(track)) {
+        man->FillH1(h + kEPrim, ekin_keV, w);
+        const auto* info = static_cast<const MyTrackInfo*>(track->GetUserInformation());
+        if (info && info->HasComptonInCone()) man->FillH1(h + kECompton, ekin_keV, w);
+    } else {
+        man->FillH1(h + kESec, ekin_keV, w);
+    }
+    man->FillH1(h + kR, std::sqrt(x_mm*x_mm + y_mm*y_mm), w);
+    man->FillH2(fH2[plane], x_mm, y_mm, w);
+}
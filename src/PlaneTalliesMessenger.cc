@@ -0,0 +1,37 @@
+#include "PlaneTalliesMessenger.hh"
+#include "PlaneTallies.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : le mode de sortie est
+//  partagé par tous les threads, les commandes ne sont donc pas retransmises.
+PlaneTalliesMessenger::PlaneTalliesMessenger()
+{
+    fDir = new G4UIdirectory("/tallies/");
+    fDir->SetGuidance("Sortie des plans de comptage : ntuples de passages et/ou histogrammes binnés.");
+
+    fModeCmd = new G4UIcmdWithAString("/tallies/mode", this);
+    fModeCmd->SetGuidance("ntuple  : une ligne par traversée (ntuples *_passages, défaut).");
+    fModeCmd->SetGuidance("tallies : histogrammes E, r, x-y par plan seulement (fichier de quelques ko).");
+    fModeCmd->SetGuidance("both    : les deux.");
+    fModeCmd->SetParameterName("mode", false);
+    fModeCmd->SetCandidates("ntuple tallies both");
+    fModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fModeCmd->SetToBeBroadcasted(false);
+}
+
+PlaneTalliesMessenger::~PlaneTalliesMessenger()
+{
+    delete fModeCmd;
+    delete fDir;
+}
+
+void PlaneTalliesMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fModeCmd) {
+        if (value == "tallies")   PlaneTallies::SetMode(PlaneTallies::kTallies);
+        else if (value == "both") PlaneTallies::SetMode(PlaneTallies::kBoth);
+        else                      PlaneTallies::SetMode(PlaneTallies::kNtuple);
+    }
+}
@@ -4,10 +4,13 @@
 #include "PrimaryGeneratorAction1.hh"
 #include "PrimaryGeneratorAction2.hh"
 #include "PrimaryGeneratorAction3.hh"
+#include "PrimaryGeneratorAction4.hh"
+#include "PrimaryGeneratorAction5.hh"
 
 #include "PrimaryGeneratorMessenger.hh"
 
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
@@ -32,6 +35,8 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
     fAction1 = new PrimaryGeneratorAction1(fParticleGun);
     fAction2 = new PrimaryGeneratorAction2(fParticleGun);
     fAction3 = new PrimaryGeneratorAction3(fParticleGun);
+    fAction4 = new PrimaryGeneratorAction4();
+    fAction5 = new PrimaryGeneratorAction5(fParticleGun);
 
     //create a messenger for this class
     fGunMessenger = new PrimaryGeneratorMessenger(this);
@@ -45,6 +50,8 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
     delete fAction1;
     delete fAction2;
     delete fAction3;
+    delete fAction4;
+    delete fAction5;
 
     delete fGunMessenger;
 }
@@ -52,6 +59,25 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event *anEvent)
 {
     //G4cout << "ISelected generator fAction " << fSelectedAction<<G4endl;
+    // Rejeu d'espace des phases : les retours vers l'amont du plan seront arrêtés
+    PhaseSpace::SetReplaying(fSelectedAction == 4);
+
+    // [ADD] N primaires indépendants : chaque appel ajoute ses propres vertex.
+    //       Les particules primaires de l'appel i reçoivent le rang i, hérité
+    //       ensuite par leurs secondaires (TrackingAction -> MyTrackInfo).
+    fPrimarySlots.clear();
+    for (G4int i = 0; i < fPrimariesPerEvent; ++i) {
+        const G4int firstVertex = anEvent->GetNumberOfPrimaryVertex();
+        GenerateOne(anEvent);
+        for (G4int v = firstVertex; v < anEvent->GetNumberOfPrimaryVertex(); ++v) {
+            fPrimarySlots.insert(fPrimarySlots.end(), anEvent->GetPrimaryVertex(v)->GetNumberOfParticle(), i);
+        }
+    }
+    fNbPrimarySlots = fPrimariesPerEvent;
+}
+
+void PrimaryGeneratorAction::GenerateOne(G4Event *anEvent)
+{
     switch(fSelectedAction)
     {
         case 0:
@@ -66,6 +92,12 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event *anEvent)
         case 3:
             fAction3->GeneratePrimaries(anEvent);
             break;
+        case 4:
+            fAction4->GeneratePrimaries(anEvent);
+            break;
+        case 5:
+            fAction5->GeneratePrimaries(anEvent);
+            break;
         default:
             G4cerr << "Invalid generator fAction" << G4endl;
     }
@@ -0,0 +1,76 @@
+#include "PrimaryGeneratorAction4.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4ParticleTable.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction4::GeneratePrimaries(G4Event* anEvent){
+
+  // Nouveau run : l'état local repart de zéro (le lecteur partagé est
+  // réinitialisé par PhaseSpace::BeginRun)
+  //
+  const auto* run = G4RunManager::GetRunManager()->GetCurrentRun();
+  const G4int runID = run ? run->GetRunID() : -1;
+  if (runID != fRunID) {
+    fRunID = runID;
+    fExhausted = false;
+  }
+
+  // Histoire suivante du fichier
+  //
+  if (fExhausted || !PhaseSpace::NextHistory(fHistory)) {
+    // Fichiers épuisés sans /phasespace/recycle : événement vide, fin du run
+    if (!fExhausted) {
+      G4cout << "[PSF] Espace des phases épuisé à l'événement " << anEvent->GetEventID()
+             << " : arrêt du run (/phasespace/recycle true pour recycler)" << G4endl;
+      G4RunManager::GetRunManager()->AbortRun(true);
+    }
+    fExhausted = true;
+    return;
+  }
+
+  // [FIX] Les "reuse" rejeux d'une histoire sont corrélés : ils sont tous émis
+  //       dans CET appel, donc dans le même rang de primaire (MyTrackInfo),
+  //       et forment une seule histoire statistique pour les sommes e / e²
+  //       du run (HistoryMean, FOM) et du maillage de dose.
+  //
+  auto* table = G4ParticleTable::GetParticleTable();
+  fParticles.clear();
+  for (const auto& rec : fHistory) {
+    fParticles.push_back(table->FindParticle(PhaseSpace::ParticleName(rec.type)));
+  }
+
+  const G4int reuse = PhaseSpace::GetReuse();
+  const G4double weightScale = 1./reuse;
+  for (G4int k = 0; k < reuse; ++k) {
+    // Rotation azimutale commune à tout le rejeu
+    const G4double phi = PhaseSpace::GetRotate() ? twopi*G4UniformRand() : 0.;
+
+    for (std::size_t i = 0; i < fHistory.size(); ++i) {
+      if (!fParticles[i]) continue;
+      const auto& rec = fHistory[i];
+      G4ThreeVector pos = rec.position;
+      G4ThreeVector dir = rec.direction;
+      if (phi != 0.) { pos.rotateZ(phi); dir.rotateZ(phi); }
+
+      auto* primary = new G4PrimaryParticle(fParticles[i]);
+      primary->SetKineticEnergy(rec.ekin);
+      primary->SetMomentumDirection(dir);
+      primary->SetWeight(rec.weight*weightScale);
+
+      auto* vertex = new G4PrimaryVertex(pos, 0.);
+      vertex->SetPrimary(primary);
+      anEvent->AddPrimaryVertex(vertex);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
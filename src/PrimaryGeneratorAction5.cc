@@ -0,0 +1,94 @@
+#include "PrimaryGeneratorAction5.hh"
+#include "TubeSourceModel.hh"
+#include "RunAction.hh"
+
+#include "G4Event.hh"
+#include "G4ParticleGun.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4AnalysisManager.hh"
+#include "Randomize.hh"
+#include "globals.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryGeneratorAction5::PrimaryGeneratorAction5(G4ParticleGun* gun)
+: fParticleGun(gun)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction5::GeneratePrimaries(G4Event* anEvent){
+
+  // Tables courantes (figées pendant le run, modifiées seulement en Idle par le master)
+  //
+  const auto* heel = TubeSourceModel::GetHeelTable();
+  const auto* spot = TubeSourceModel::GetFocalSpot();
+  if (!heel) {
+    // Pas de spectre angulaire : événement vide, fin du run
+    const auto* run = G4RunManager::GetRunManager()->GetCurrentRun();
+    const G4int runID = run ? run->GetRunID() : -1;
+    if (runID != fRunID) {
+      fRunID = runID;
+      G4Exception("PrimaryGeneratorAction5", "TUBE005", JustWarning,
+                  "Source 5 sans /tubesource/heelTable : arrêt du run.");
+      G4RunManager::GetRunManager()->AbortRun(true);
+    }
+    return;
+  }
+
+  // Tirage d'un gamma
+  //
+  if (!fGamma) fGamma = G4ParticleTable::GetParticleTable()->FindParticle("gamma");
+  fParticleGun->SetParticleDefinition(fGamma);
+
+  // Position : pixel du foyer (ou point sur l'axe sans carte)
+  //
+  G4ThreeVector pos(0., 0., 0.001*mm);
+  if (spot) {
+    const G4double u0 = G4UniformRand();
+    const G4double u1 = G4UniformRand();
+    const G4double u2 = G4UniformRand();
+    pos = spot->Sample(u0, u1, u2);
+  }
+  fParticleGun->SetParticlePosition(pos);
+
+  // Angle polaire et énergie : loi jointe de l'effet talon ; azimut uniforme
+  //
+  G4double cosAlpha = 1., energy = 0.;
+  const G4double u0 = G4UniformRand();
+  const G4double u1 = G4UniformRand();
+  const G4double u2 = G4UniformRand();
+  const G4double u3 = G4UniformRand();
+  heel->Sample(u0, u1, u2, u3, cosAlpha, energy);
+  const G4double sinAlpha = std::sqrt(std::max(0., 1. - cosAlpha*cosAlpha));
+  const G4double psi = twopi*G4UniformRand();
+
+  fParticleGun->SetParticleMomentumDirection(
+    G4ThreeVector(sinAlpha*std::cos(psi), sinAlpha*std::sin(psi), cosAlpha));
+  fParticleGun->SetParticleEnergy(energy);
+
+  // --- Création effective du vertex ---
+  fParticleGun->GeneratePrimaryVertex(anEvent);
+
+  // --- Compteurs RunAction et histogrammes d'émission (comme la source 2) ---
+  if (const auto* ra = static_cast<const RunAction*>(
+    G4RunManager::GetRunManager()->GetUserRunAction())) {
+    ra->CountPrimary();
+    ra->IncrementValid2Particles();
+  }
+  if (auto* man = G4AnalysisManager::Instance()) {
+    man->FillH1(0, energy);                      // H0: Énergie à l'émission
+    man->FillH1(1, std::acos(cosAlpha)/deg);     // H1: Theta à l'émission
+    man->FillH1(2, psi/deg);                     // H2: Phi à l'émission
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -1,7 +1,12 @@
 #include "PrimaryGeneratorMessenger.hh"
 #include "PrimaryGeneratorAction.hh"
+#include "PrimaryGeneratorAction2.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -17,9 +22,50 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* Gun
   fSelectActionCmd->SetGuidance("1 Gamma 100keV");
   fSelectActionCmd->SetGuidance("2 Gamma Spectra");
   fSelectActionCmd->SetGuidance("3 Electron 200keV");
+  fSelectActionCmd->SetGuidance("4 Phase space (/phasespace/addInput)");
+  fSelectActionCmd->SetGuidance("5 Focal spot + heel effect (/tubesource/)");
   fSelectActionCmd->SetParameterName("id",false);
-  fSelectActionCmd->SetRange("id>=0 && id<5");
+  fSelectActionCmd->SetRange("id>=0 && id<6");
   fSelectActionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fAngularBiasCmd = new G4UIcmdWithABool("/primariesgenerator/angularBias",this);
+  fAngularBiasCmd->SetGuidance("Source 2 : echantillonnage preferentiel de l'angle d'emission");
+  fAngularBiasCmd->SetGuidance("vers l'ouverture du cone (primaires ponderes).");
+  fAngularBiasCmd->SetParameterName("on",false);
+  fAngularBiasCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBiasHalfAngleCmd = new G4UIcmdWithADoubleAndUnit("/primariesgenerator/biasHalfAngle",this);
+  fBiasHalfAngleCmd->SetGuidance("Demi-angle de l'ouverture privilegiee (defaut 5 deg).");
+  fBiasHalfAngleCmd->SetParameterName("theta",false);
+  fBiasHalfAngleCmd->SetDefaultUnit("deg");
+  fBiasHalfAngleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBiasFractionCmd = new G4UIcmdWithADouble("/primariesgenerator/biasFraction",this);
+  fBiasFractionCmd->SetGuidance("Fraction des tirages dans l'ouverture, dans ]0,1[ (defaut 0.5).");
+  fBiasFractionCmd->SetParameterName("p",false);
+  fBiasFractionCmd->SetRange("p>0. && p<1.");
+  fBiasFractionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBenchmarkEnergyCmd = new G4UIcmdWithAnInteger("/primariesgenerator/benchmarkEnergy",this);
+  fBenchmarkEnergyCmd->SetGuidance("Source 2 : micro-benchmark du tirage de l'energie (tirages/s),");
+  fBenchmarkEnergyCmd->SetGuidance("ancien InverseCumul+rejet contre table d'alias.");
+  fBenchmarkEnergyCmd->SetParameterName("n",false);
+  fBenchmarkEnergyCmd->SetRange("n>0");
+  fBenchmarkEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSpectrumCmd = new G4UIcmdWithAString("/primariesgenerator/spectrum",this);
+  fSpectrumCmd->SetGuidance("Source 2 : spectre en energie (nom /spectra/list, ou builtin).");
+  fSpectrumCmd->SetGuidance("Modifiable entre deux runs, sans recompilation.");
+  fSpectrumCmd->SetParameterName("name",false);
+  fSpectrumCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPrimariesPerEventCmd = new G4UIcmdWithAnInteger("/primariesgenerator/primariesPerEvent",this);
+  fPrimariesPerEventCmd->SetGuidance("Nombre de primaires independants par evenement (defaut 1).");
+  fPrimariesPerEventCmd->SetGuidance("Chaque primaire a son vertex ; doses et incertitudes restent par primaire.");
+  fPrimariesPerEventCmd->SetGuidance("/run/beamOn compte des evenements : histoires = evenements x N.");
+  fPrimariesPerEventCmd->SetParameterName("n",false);
+  fPrimariesPerEventCmd->SetRange("n>0");
+  fPrimariesPerEventCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -27,6 +73,12 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* Gun
 PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
 {
   delete fSelectActionCmd;
+  delete fAngularBiasCmd;
+  delete fBiasHalfAngleCmd;
+  delete fBiasFractionCmd;
+  delete fBenchmarkEnergyCmd;
+  delete fSpectrumCmd;
+  delete fPrimariesPerEventCmd;
   delete fDirGenerator;
 }
 
@@ -40,5 +92,29 @@ void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newVa
     fAction->SelectAction(SelectedAction);
     //G4cout<<"    Commande "<<SelectedAction<<G4endl;
     }
+
+  if (command == fAngularBiasCmd) {
+    fAction->GetAction2()->SetAngularBias(fAngularBiasCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fBiasHalfAngleCmd) {
+    fAction->GetAction2()->SetBiasHalfAngle(fBiasHalfAngleCmd->GetNewDoubleValue(newValue));
+  }
+
+  if (command == fBiasFractionCmd) {
+    fAction->GetAction2()->SetBiasFraction(fBiasFractionCmd->GetNewDoubleValue(newValue));
+  }
+
+  if (command == fPrimariesPerEventCmd) {
+    fAction->SetPrimariesPerEvent(fPrimariesPerEventCmd->GetNewIntValue(newValue));
+  }
+
+  if (command == fSpectrumCmd) {
+    fAction->GetAction2()->SelectSpectrum(newValue);
+  }
+
+  if (command == fBenchmarkEnergyCmd) {
+    fAction->GetAction2()->BenchmarkEnergySampling(fBenchmarkEnergyCmd->GetNewIntValue(newValue));
+  }
   }
 
@@ -0,0 +1,87 @@
+#include "ProcessRoles.hh"
+
+#include "G4BiasingProcessInterface.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessTable.hh"
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
+#include "G4Threading.hh"
+
+G4ThreadLocal G4int ProcessRoles::fKeys[ProcessRole::kNbRoles] = {-1, -1, -1, -1, -1, -1};
+
+namespace {
+    inline const char* ThreadTag() {
+#ifdef G4MULTITHREADED
+        return G4Threading::IsMasterThread() ? "[MT-MASTER]" : "[MT-WORKER]";
+#else
+        return "[SEQ]";
+#endif
+    }
+
+    struct ProcessRef {
+        G4int role;
+        const char* name;
+        G4bool onElectron;   // processus cherché sur e- (sinon sur gamma)
+    };
+
+    const ProcessRef kRefs[] = {
+        { ProcessRole::kCompton,        "compt",          false },
+        { ProcessRole::kPhotoElectric,  "phot",           false },
+        { ProcessRole::kTransportation, "Transportation", false },
+        { ProcessRole::kMsc,            "msc",            true  },
+    };
+}
+
+void ProcessRoles::Build()
+{
+    auto* table = G4ProcessTable::GetProcessTable();
+
+    G4cout << ThreadTag() << " [PROC] Process roles :";
+    for (const auto& ref : kRefs) {
+        const G4ParticleDefinition* part = ref.onElectron
+            ? static_cast<G4ParticleDefinition*>(G4Electron::Definition())
+            : static_cast<G4ParticleDefinition*>(G4Gamma::Definition());
+        const G4VProcess* proc = table ? table->FindProcess(ref.name, part) : nullptr;
+        // Processus enveloppé par le biais générique (option -f) : le wrapper
+        // reprend type et sous-type du processus physique, la clé est la même
+        if (!proc && table) {
+            proc = table->FindProcess(G4String("biasWrapper(") + ref.name + ")", part);
+        }
+
+        fKeys[ref.role] = proc ? Key(proc) : -1;
+        G4cout << " " << ref.name << "=" << fKeys[ref.role];
+        if (!proc) G4cout << "(absent)";
+    }
+
+    // [FIX] Limiteur du biais générique (NonPhysicsBias, option -f) : pas de nom
+    //       fixe, repéré comme wrapper sans processus enveloppé
+    fKeys[ProcessRole::kNonPhysical] = -1;
+    for (const G4ParticleDefinition* part : {static_cast<G4ParticleDefinition*>(G4Gamma::Definition()),
+                                             static_cast<G4ParticleDefinition*>(G4Electron::Definition())}) {
+        const G4ProcessManager* manager = part->GetProcessManager();
+        const G4ProcessVector* list = manager ? manager->GetProcessList() : nullptr;
+        for (std::size_t i = 0; list && i < list->size(); ++i) {
+            const auto* wrapper = dynamic_cast<const G4BiasingProcessInterface*>((*list)[i]);
+            if (wrapper && !wrapper->GetWrappedProcess()) {
+                fKeys[ProcessRole::kNonPhysical] = Key(wrapper);
+                break;
+            }
+        }
+        if (fKeys[ProcessRole::kNonPhysical] >= 0) break;
+    }
+    G4cout << " biasLimiter=" << fKeys[ProcessRole::kNonPhysical];
+    if (fKeys[ProcessRole::kNonPhysical] < 0) G4cout << "(absent)";
+    G4cout << G4endl;
+}
+
+const char* ProcessRoles::RoleName(G4int role)
+{
+    switch (role) {
+        case ProcessRole::kCompton:        return "compt";
+        case ProcessRole::kPhotoElectric:  return "phot";
+        case ProcessRole::kTransportation: return "Transportation";
+        case ProcessRole::kMsc:            return "msc";
+        case ProcessRole::kNonPhysical:    return "nonPhysical";
+        default:                           return "other";
+    }
+}
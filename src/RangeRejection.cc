@@ -0,0 +1,139 @@
+#include "RangeRejection.hh"
+#include "RangeRejectionMessenger.hh"
+
+#include "VolumeRoles.hh"
+#include "PhaseSpace.hh"
+#include "DoseMesh.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4RotationMatrix.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// ==================== Configuration partagée ====================
+//  Matériaux denses du tube et du collimateur (anode, laiton, inox, cône)
+G4bool                RangeRejection::fEnabled   = false;
+G4double              RangeRejection::fMaxEnergy = 100.*keV;
+std::set<std::string> RangeRejection::fMaterialNames = {
+    "Tungsten", "Brass", "StainlessSteel304", "G4_GRAPHITE"
+};
+std::vector<G4bool>   RangeRejection::fByIndex;
+std::vector<RangeRejection::Box> RangeRejection::fScorerBoxes;
+RangeRejectionMessenger* RangeRejection::fMessenger = nullptr;
+
+namespace {
+    // Volumes comptés comme scoreurs : rôles de VolumeRoles + plans 2, 3, 5
+    // (SD attachés par nom dans ConstructSDandField)
+    G4bool IsScorer(const G4LogicalVolume* lv)
+    {
+        switch (VolumeRoles::Of(lv).role) {
+            case VolumeRole::kScorePlane:
+            case VolumeRole::kWaterRing:
+            case VolumeRole::kWaterCube:
+            case VolumeRole::kSphereWater:
+                return true;
+            default:
+                break;
+        }
+        const G4String& name = lv->GetName();
+        return name == "logicScorePlane2" || name == "logicScorePlane3" || name == "logicScorePlane5";
+    }
+
+    // Parcours de l'arbre des placements : boîte englobante globale de chaque
+    // scoreur (les 8 coins du BoundingLimits local transformés, donc
+    // conservatrice même avec une rotation). Les volumes répliqués ne sont
+    // pas descendus (translation sans signification).
+    template <typename Box>
+    void CollectScorers(const G4LogicalVolume* lv, const G4RotationMatrix& rot,
+                        const G4ThreeVector& tr, std::vector<Box>& out)
+    {
+        if (IsScorer(lv)) {
+            G4ThreeVector pmin, pmax;
+            lv->GetSolid()->BoundingLimits(pmin, pmax);
+            Box box{G4ThreeVector(DBL_MAX, DBL_MAX, DBL_MAX), G4ThreeVector(-DBL_MAX, -DBL_MAX, -DBL_MAX)};
+            for (G4int i = 0; i < 8; ++i) {
+                const G4ThreeVector corner((i & 1) ? pmax.x() : pmin.x(),
+                                           (i & 2) ? pmax.y() : pmin.y(),
+                                           (i & 4) ? pmax.z() : pmin.z());
+                const G4ThreeVector g = rot * corner + tr;
+                box.min.set(std::min(box.min.x(), g.x()), std::min(box.min.y(), g.y()), std::min(box.min.z(), g.z()));
+                box.max.set(std::max(box.max.x(), g.x()), std::max(box.max.y(), g.y()), std::max(box.max.z(), g.z()));
+            }
+            out.push_back(box);
+        }
+        for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i) {
+            const G4VPhysicalVolume* pv = lv->GetDaughter(i);
+            if (!pv || pv->IsReplicated()) continue;
+            CollectScorers(pv->GetLogicalVolume(), rot * pv->GetObjectRotationValue(),
+                           rot * pv->GetObjectTranslation() + tr, out);
+        }
+    }
+}
+
+void RangeRejection::Init()
+{
+    // Configuration commune à tous les threads : un seul messenger (master / SEQ)
+    if (G4Threading::IsMasterThread() && !fMessenger) fMessenger = new RangeRejectionMessenger();
+}
+
+void RangeRejection::PrintMaterials()
+{
+    G4cout << "[RANGE] Rejet par la portée : " << (fEnabled ? "ACTIVÉ" : "désactivé")
+           << " | e- <= " << fMaxEnergy/keV << " keV | matériaux :";
+    for (const auto& name : fMaterialNames) {
+        G4cout << " " << name;
+        if (!G4Material::GetMaterial(name, /*warning=*/false)) G4cout << "(absent)";
+    }
+    G4cout << G4endl;
+}
+
+void RangeRejection::BeginRun()
+{
+    // Table partagée, lue seule par les workers : le BeginOfRunAction du master
+    // précède les leurs (même schéma que VolumeRoles)
+    if (!G4Threading::IsMasterThread()) return;
+
+    const auto* table = G4Material::GetMaterialTable();
+    fByIndex.assign(table->size(), false);
+    for (const auto* mat : *table) {
+        if (mat && fMaterialNames.count(mat->GetName())) fByIndex[mat->GetIndex()] = true;
+    }
+    PrintMaterials();
+
+    // Scoreurs du run : géométrie (boîtes des volumes), plan d'espace des
+    // phases en écriture (tranche infinie), boîte du maillage de dose
+    // (élargie d'un demi-voxel : arrondi du nombre de voxels)
+    fScorerBoxes.clear();
+    if (!fEnabled) return;
+    const auto* world = G4TransportationManager::GetTransportationManager()
+                            ->GetNavigatorForTracking()->GetWorldVolume();
+    if (world) CollectScorers(world->GetLogicalVolume(), G4RotationMatrix(), G4ThreeVector(), fScorerBoxes);
+    if (PhaseSpace::IsWriting()) {
+        const G4double z = PhaseSpace::GetPlaneZ();
+        fScorerBoxes.push_back({G4ThreeVector(-DBL_MAX, -DBL_MAX, z), G4ThreeVector(DBL_MAX, DBL_MAX, z)});
+    }
+    if (DoseMesh::IsEnabled()) {
+        const G4ThreeVector half = DoseMesh::GetHalfSize() + 0.5 * DoseMesh::GetVoxelSize();
+        fScorerBoxes.push_back({DoseMesh::GetCenter() - half, DoseMesh::GetCenter() + half});
+    }
+    G4cout << "[RANGE] " << fScorerBoxes.size() << " scoreur(s) pour la distance de rejet" << G4endl;
+}
+
+G4double RangeRejection::DistanceToScorers(const G4ThreeVector& p)
+{
+    G4double d2 = DBL_MAX;
+    for (const auto& box : fScorerBoxes) {
+        const G4double dx = std::max({box.min.x() - p.x(), 0., p.x() - box.max.x()});
+        const G4double dy = std::max({box.min.y() - p.y(), 0., p.y() - box.max.y()});
+        const G4double dz = std::max({box.min.z() - p.z(), 0., p.z() - box.max.z()});
+        d2 = std::min(d2, dx*dx + dy*dy + dz*dz);
+    }
+    return (d2 < DBL_MAX) ? std::sqrt(d2) : DBL_MAX;
+}
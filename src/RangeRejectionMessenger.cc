@@ -0,0 +1,72 @@
+#include "RangeRejectionMessenger.hh"
+#include "RangeRejection.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : la liste des matériaux est
+//  partagée par tous les threads, les commandes ne sont donc pas retransmises.
+RangeRejectionMessenger::RangeRejectionMessenger()
+{
+    fDir = new G4UIdirectory("/rangeRejection/");
+    fDir->SetGuidance("Rejet des électrons dont la portée est inférieure à la safety du volume.");
+
+    fEnableCmd = new G4UIcmdWithABool("/rangeRejection/enable", this);
+    fEnableCmd->SetGuidance("Active le rejet par la portée (e-, volumes non scoreurs).");
+    fEnableCmd->SetParameterName("on", false);
+    fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEnableCmd->SetToBeBroadcasted(false);
+
+    fAddMaterialCmd = new G4UIcmdWithAString("/rangeRejection/addMaterial", this);
+    fAddMaterialCmd->SetGuidance("Ajoute un matériau (nom G4Material) où le rejet s'applique.");
+    fAddMaterialCmd->SetParameterName("material", false);
+    fAddMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fAddMaterialCmd->SetToBeBroadcasted(false);
+
+    fRemoveMaterialCmd = new G4UIcmdWithAString("/rangeRejection/removeMaterial", this);
+    fRemoveMaterialCmd->SetGuidance("Retire un matériau de la liste.");
+    fRemoveMaterialCmd->SetParameterName("material", false);
+    fRemoveMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRemoveMaterialCmd->SetToBeBroadcasted(false);
+
+    fMaxEnergyCmd = new G4UIcmdWithADoubleAndUnit("/rangeRejection/maxEnergy", this);
+    fMaxEnergyCmd->SetGuidance("Énergie cinétique maximale des électrons candidats au rejet.");
+    fMaxEnergyCmd->SetParameterName("eMax", false);
+    fMaxEnergyCmd->SetDefaultUnit("keV");
+    fMaxEnergyCmd->SetRange("eMax>0.");
+    fMaxEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fMaxEnergyCmd->SetToBeBroadcasted(false);
+
+    fListCmd = new G4UIcmdWithoutParameter("/rangeRejection/list", this);
+    fListCmd->SetGuidance("Affiche l'état du rejet et la liste des matériaux.");
+    fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fListCmd->SetToBeBroadcasted(false);
+}
+
+RangeRejectionMessenger::~RangeRejectionMessenger()
+{
+    delete fEnableCmd;
+    delete fAddMaterialCmd;
+    delete fRemoveMaterialCmd;
+    delete fMaxEnergyCmd;
+    delete fListCmd;
+    delete fDir;
+}
+
+void RangeRejectionMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fEnableCmd) {
+        RangeRejection::SetEnabled(fEnableCmd->GetNewBoolValue(value));
+    } else if (command == fAddMaterialCmd) {
+        RangeRejection::AddMaterial(value);
+    } else if (command == fRemoveMaterialCmd) {
+        RangeRejection::RemoveMaterial(value);
+    } else if (command == fMaxEnergyCmd) {
+        RangeRejection::SetMaxEnergy(fMaxEnergyCmd->GetNewDoubleValue(value));
+    } else if (command == fListCmd) {
+        RangeRejection::PrintMaterials();
+    }
+}
@@ -1,5 +1,6 @@
 #include "RunAction.hh"
 #include "EventAction.hh"
+#include "SteppingAction.hh"
 #include "AnalysisManagerSetup.hh"
 
 #include "G4AnalysisManager.hh"
@@ -13,22 +14,30 @@
 #include "G4RunManager.hh"
 #include "G4SDManager.hh"
 #include "SurfaceSpectrumSD.hh"
+#include "RunLedger.hh"
+#include "ProcessRoles.hh"
+#include "Diagnostics.hh"
 
+#include "G4Material.hh"
+#include "G4VProcess.hh"
+#include "G4LogicalVolume.hh"
+
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 
-#include "SphereHit.hh"
-#include "SteppingAction.hh"  // Pour le suivi step par step
-
-extern G4long gEnterPlanePrim;
-extern G4long gLeavePlanePrim;
-
-extern G4long gEnterPlanePrim;
-extern G4long gLeavePlanePrim;
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
 
-// maps définies dans SteppingAction.cc
-extern std::map<std::string,int> gLostByProc;
-extern std::map<std::string,int> gLostByMat;
+#include "SphereHit.hh"
+#include "StepTracer.hh"  // Pour le suivi step par step
+#include "ImportanceWorld.hh"
+#include "TrackKiller.hh"
+#include "RangeRejection.hh"
+#include "PhaseSpace.hh"
+#include "PlaneTallies.hh"
 
 // ============================================================================
 // [ADD] Helper de logs : SEQ en mono-thread, sinon MT-MASTER / MT-WORKER
@@ -42,7 +51,49 @@ namespace {
         #endif
     }
     // [ADD] Protéger SetupAnalysis() contre une double exécution (si 2 ctors utilisés)
-    static bool gAnalysisSetupDone = false;
+    // [FIX] G4ThreadLocal : en MT chaque thread possède son propre G4AnalysisManager,
+    //       les histos/ntuples doivent donc être créés une fois PAR THREAD.
+    G4ThreadLocal bool gAnalysisSetupDone = false;
+
+    // [ADD] Vrai si ce thread possède des SensitiveDetectors
+    //       (en MT, ConstructSDandField() n'est appelé que sur les workers)
+    inline bool ThreadHasSD() {
+        return !G4Threading::IsMultithreadedApplication() || G4Threading::IsWorkerThread();
+    }
+
+    // [ADD] Pic de mémoire résidente du processus en Mo (-1 si indisponible)
+    inline G4double PeakRSS_MB() {
+#if defined(__APPLE__)
+        rusage ru{};
+        return (getrusage(RUSAGE_SELF, &ru) == 0) ? ru.ru_maxrss / (1024. * 1024.) : -1.;  // octets
+#elif defined(__unix__)
+        rusage ru{};
+        return (getrusage(RUSAGE_SELF, &ru) == 0) ? ru.ru_maxrss / 1024. : -1.;            // Ko
+#else
+        return -1.;
+#endif
+    }
+
+    // [ADD] Estimateur par histoire : à partir de la somme S et de la somme des
+    //       carrés S2 des scores d'événement (pondérés), moyenne par événement et
+    //       écart-type de cette moyenne. En analogue, S est la somme habituelle.
+    inline void HistoryMean(G4double s, G4double s2, G4long n, G4double& mean, G4double& sigma) {
+        mean = 0.; sigma = 0.;
+        if (n <= 0) return;
+        mean = s / n;
+        if (n > 1) sigma = std::sqrt(std::max(0., (s2 / n - mean * mean) / (n - 1)));
+    }
+
+    inline G4double RelPercent(G4double mean, G4double sigma) {
+        return (mean != 0.) ? 100. * sigma / std::abs(mean) : 0.;
+    }
+
+    // [ADD] Figure de mérite 1/(R^2 T), R = sigma/moyenne, T en secondes (0 si indéfinie)
+    inline G4double FigureOfMerit(G4double mean, G4double sigma, G4double wall) {
+        if (mean == 0. || sigma <= 0. || wall <= 0.) return 0.;
+        const G4double rel = sigma / std::abs(mean);
+        return 1. / (rel * rel * wall);
+    }
 } // namespace
 
 //  Ce constructeur initialise les accumulateurs globaux utilisés pour compter, sur l’ensemble du run :
@@ -68,18 +119,7 @@ RunAction::RunAction()
 : fTotalEntrantInBe(0), fTotalInteractedInBe(0),
 fTotalEntrantInWaterSphere(0), fTotalInteractedInWaterSphere(0)
 {
-    auto accMgr = G4AccumulableManager::Instance();
-    accMgr->Register(fTotalEntrantInBe);
-    accMgr->Register(fTotalInteractedInBe);
-    accMgr->Register(fTotalEntrantInWaterSphere);
-    accMgr->Register(fTotalInteractedInWaterSphere);
-
-    accMgr->Register(fNValidParticles_lt_35);
-    accMgr->Register(fNValidParticles_gt_35);
-
-
-    // [ADD] compteur global des primaires (option B)
-    accMgr->Register(fPrimariesGenerated);
+    RegisterAccumulables();
 
     fRunMessenger = new RunMessenger(this);
 
@@ -87,6 +127,8 @@ fTotalEntrantInWaterSphere(0), fTotalInteractedInWaterSphere(0)
     if (!gAnalysisSetupDone) {
         auto* am = G4AnalysisManager::Instance();
         am->SetActivation(true);   // [ADD] ACTIVER avant de créer les ntuples
+        // [ADD] MT : les lignes des workers sont fusionnées dans un seul output.root
+        if (G4Threading::IsMultithreadedApplication()) am->SetNtupleMerging(true);
         SetupAnalysis();           // [ADD] crée les ntuples/colonnes une seule fois
         gAnalysisSetupDone = true;
     }
@@ -107,17 +149,7 @@ RunAction::RunAction(EventAction* eventAction)
 : fTotalEntrantInBe(0), fTotalInteractedInBe(0),
 fTotalEntrantInWaterSphere(0), fTotalInteractedInWaterSphere(0)
 {
-    auto accMgr = G4AccumulableManager::Instance();
-    accMgr->Register(fTotalEntrantInBe);
-    accMgr->Register(fTotalInteractedInBe);
-    accMgr->Register(fTotalEntrantInWaterSphere);
-    accMgr->Register(fTotalInteractedInWaterSphere);
-
-    accMgr->Register(fNValidParticles_lt_35);
-    accMgr->Register(fNValidParticles_gt_35);
-
-    // [ADD] compteur global des primaires (option B)
-    accMgr->Register(fPrimariesGenerated);
+    RegisterAccumulables();
 
     fRunMessenger = new RunMessenger(this);
 
@@ -125,6 +157,7 @@ fTotalEntrantInWaterSphere(0), fTotalInteractedInWaterSphere(0)
     if (!gAnalysisSetupDone) {
         auto* am = G4AnalysisManager::Instance();
         am->SetActivation(true);   // [ADD]
+        if (G4Threading::IsMultithreadedApplication()) am->SetNtupleMerging(true);
         SetupAnalysis();           // [ADD]
         gAnalysisSetupDone = true;
     }
@@ -134,6 +167,58 @@ fTotalEntrantInWaterSphere(0), fTotalInteractedInWaterSphere(0)
 RunAction::~RunAction(){
     delete fRunMessenger;}
 
+//  Enregistrement de TOUS les accumulables du run.
+//  En MT, G4AccumulableManager::Merge() associe les accumulables des workers à ceux
+//  du master par leur rang d'enregistrement : l'ordre doit donc être strictement le
+//  même dans les deux constructeurs (d'où cette méthode unique).
+void RunAction::RegisterAccumulables()
+{
+    auto accMgr = G4AccumulableManager::Instance();
+    accMgr->Register(fTotalEntrantInBe);
+    accMgr->Register(fTotalInteractedInBe);
+    accMgr->Register(fTotalEntrantInWaterSphere);
+    accMgr->Register(fTotalInteractedInWaterSphere);
+
+    accMgr->Register(fNValidParticles_lt_35);
+    accMgr->Register(fNValidParticles_gt_35);
+
+    // [ADD] compteur global des primaires (option B)
+    accMgr->Register(fPrimariesGenerated);
+
+    // [ADD] Énergies déposées dans l'eau (sommes du run)
+    for (G4int i = 0; i < kNbWaterRings; i++) {
+        accMgr->Register(fTotalEdepRing[i]);
+    }
+    accMgr->Register(fTotalEdepWater);
+    accMgr->Register(fTransmittedTotal);
+
+    // [ADD] Sommes des carrés (variance des tallies pondérés) et transmission pondérée
+    for (G4int i = 0; i < kNbWaterRings; i++) {
+        accMgr->Register(fTotalEdepRing2[i]);
+    }
+    accMgr->Register(fTotalEdepWater2);
+    // [ADD] Kerma des anneaux par longueur de trace (sommes et carrés)
+    for (G4int i = 0; i < kNbWaterRings; i++) {
+        accMgr->Register(fTotalKermaRing[i]);
+        accMgr->Register(fTotalKermaRing2[i]);
+    }
+    accMgr->Register(fTransmittedW);
+    accMgr->Register(fTransmittedW2);
+
+    // [ADD] Compteurs côté Stepping (ex-globaux de SteppingAction.cc)
+    accMgr->Register(fEnterPlanePrim);
+    accMgr->Register(fLeavePlanePrim);
+    accMgr->Register(&fLostByProc);
+    accMgr->Register(&fLostByMat);
+    accMgr->Register(&fKilledByVol);
+    accMgr->Register(&fRangeRejectedByMat);
+    // [ADD] Maillage 3D de dose (blocs creux)
+    accMgr->Register(&fDoseMesh);
+
+    // [ADD] Registre de compteurs sans verrou (Stepping + SD), instance du thread courant
+    accMgr->Register(RunLedger::Instance());
+}
+
 G4int RunAction::GetTotalEntrantInBe() const {
     return fTotalEntrantInBe.GetValue();}
 
@@ -149,15 +234,30 @@ G4int RunAction::GetTotalInteractedInWaterSphere() const {
 void RunAction::BeginOfRunAction(const G4Run* run)
 {
     // ==================== Step Tracking ====================
-    // Réinitialiser le compteur et imprimer l'en-tête du tableau
-    SteppingAction::ResetTrackedParticlesCount();
+    // Réinitialiser le budget d'événements suivis et imprimer l'en-tête du tableau
+    StepTracer::BeginRun();
     // =======================================================
 
+    // [ADD] Clés (type, sous-type) des processus utiles, pour le G4ProcessTable de ce thread
+    ProcessRoles::Build();
+
+    // [ADD] Importances des tranches -> G4IStore du thread (sans effet sans l'option -i)
+    ImportanceWorld::BeginRun();
+
+    // [ADD] Politique d'arrêt géométrique (affichage master/SEQ)
+    TrackKiller::BeginRun();
+
+    // [ADD] Matériaux du rejet par la portée -> table par index (master, avant les workers)
+    RangeRejection::BeginRun();
+
+    // [ADD] Espace des phases : fichier d'écriture du thread, lecteur partagé (master)
+    PhaseSpace::BeginRun();
+
     auto* am = G4AnalysisManager::Instance();
 
-    #ifdef G4MULTITHREADED
-    if (!G4Threading::IsMasterThread()) return;
-    #endif
+    // [FIX] Plus de retour anticipé sur les workers : en MT chaque thread ouvre
+    //       « son » fichier (fusion des histos/ntuples vers le master à Write()),
+    //       et remet à zéro SES accumulables et SES tampons.
 
     //G4cout << ThreadTag() << " [RUN] BeginOfRunAction: start run "<< run->GetRunID() << G4endl;
 
@@ -166,6 +266,9 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     am->SetActivation(true);                                                  // [ADD]
     //G4cout << ThreadTag() << " [RUN] IsActive AFTER  = " << am->IsActive() << G4endl; // [LOG]
 
+    // [ADD] Plans de comptage : ntuples de passages et/ou tallies binnés (/tallies/mode)
+    PlaneTallies::BeginRun();
+
     // [ADD] Ouvrir (ou rouvrir) le fichier en début de run
     am->OpenFile("output.root");
     //G4cout << ThreadTag() << " [RUN] Opened analysis file: output.root" << G4endl;    // [LOG]
@@ -174,17 +277,30 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     //G4cout << "[RUN] plane_passages ntuple id = " << GetPlanePassageNtupleId() << G4endl; // [LOG]
 
 
-    // Réinitialiser les accumulateurs pour ce run
+    // Réinitialiser les accumulateurs pour ce run (instance du thread courant)
     G4AccumulableManager::Instance()->Reset();
 
+    // [ADD] Maillage 3D de dose : grille du run (/dosemesh/), identique sur tous les threads
+    fDoseMesh.BeginRun();
+
+    // [FIX] Registre d'observateurs du stepping reconstruit pour ce run : les
+    //       observateurs optionnels (dose, espace des phases, kill, range
+    //       rejection) ne sont enregistrés que si leur macro les active.
+    //       (pas de SteppingAction sur le master MT)
+    if (auto* stepping = const_cast<SteppingAction*>(static_cast<const SteppingAction*>(
+            G4RunManager::GetRunManager()->GetUserSteppingAction()))) {
+        stepping->BeginRun();
+    }
+
 
     // [KEEP] Câblage du SensitiveDetector « SpecSD » vers l’ID de l’ntuple plane_passages
-    {
+    //        (uniquement là où les SD existent : SEQ ou worker MT)
+    if (ThreadHasSD()) {
         auto* sdMan = G4SDManager::GetSDMpointer();
         if (auto* sd = dynamic_cast<SurfaceSpectrumSD*>(
             sdMan->FindSensitiveDetector("SpecSD", /*depthSearch*/ false))) {
             sd->SetPassageNtupleId(GetPlanePassageNtupleId());
-        G4cout << "[RUN] SpecSD wired to plane_passages ntuple id = "
+        G4cout << ThreadTag() << " [RUN] SpecSD wired to plane_passages ntuple id = "
         << GetPlanePassageNtupleId() << G4endl;                    // [LOG]
         } else {
             G4cout << "[RUN][WARN] SpecSD not found; plane_passages ntuple will not be filled."
@@ -192,22 +308,52 @@ void RunAction::BeginOfRunAction(const G4Run* run)
         }
     }
 
-    // Initialiser les compteurs pour ce run
-     fNValidParticles_lt_35 = 0;
-     fNValidParticles_gt_35 = 0;
-     
-    // Réinitialiser les accumulateurs d'énergie pour ce run
+    // Réinitialiser les tampons par lot de 10000 événements (propres au thread)
     for (G4int i = 0; i < kNbWaterRings; i++) {
-        fTotalEdepRing[i] = 0.0;
         fEdepRing10000[i] = 0.0;
+        fKermaRing10000[i] = 0.0;
     }
-    fTotalEdepWater = 0.0;
     fEdepWater10000 = 0.0;
-    fLastHistoFillEvent = -10000;
-    
-    // Réinitialiser les compteurs de photons transmis
+    fEventsInBatch = 0;
     fTransmitted10000 = 0;
-    fTransmittedTotal = 0;
+    fTransmittedWeightEvent.clear();
+
+    fLostByMatPtr.clear();
+    fLostByProcPtr.clear();
+    fKilledByVolPtr.clear();
+    fRangeRejectedByMatPtr.clear();
+
+    // [ADD] Chrono du run (seul celui du master/SEQ est affiché : débit global)
+    fRunTimer.Start();
+}
+
+void RunAction::FlushLostPrimaries()
+{
+    for (const auto& kv : fLostByMatPtr) {
+        fLostByMat.Increment(kv.first ? std::string(kv.first->GetName()) : "Unknown", kv.second);
+    }
+    for (const auto& kv : fLostByProcPtr) {
+        fLostByProc.Increment(kv.first ? std::string(kv.first->GetProcessName()) : "Unknown", kv.second);
+    }
+    fLostByMatPtr.clear();
+    fLostByProcPtr.clear();
+}
+
+void RunAction::FlushKilledTracks()
+{
+    for (const auto& kv : fKilledByVolPtr) {
+        const std::string name = kv.first ? std::string(kv.first->GetName()) : "Unknown";
+        fKilledByVol.Increment(name, kv.second.first);
+        fKilledByVol.AddSum(name, kv.second.second);
+    }
+    fKilledByVolPtr.clear();
+
+    for (const auto& kv : fRangeRejectedByMatPtr) {
+        const std::string name = kv.first ? std::string(kv.first->GetName()) : "Unknown";
+        fRangeRejectedByMat.Increment(name, kv.second.first);
+        fRangeRejectedByMat.AddSum(name, kv.second.second);
+    }
+    fRangeRejectedByMatPtr.clear();
 }
 
 //  La fonction RunAction::EndOfRunAction(const G4Run*)est appelée automatiquement
@@ -217,8 +363,10 @@ void RunAction::BeginOfRunAction(const G4Run* run)
 //      - Afficher un résumé du run
 //      - Afficher un bilan des hits par événement
 //      - Fermer correctement le fichier d’analyse
-void RunAction::EndOfRunAction(const G4Run*)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
+    fRunTimer.Stop();
+
     auto* am = G4AnalysisManager::Instance();
     //G4cout << "[RunAction] Fin du run, appel à FinalizeAnalysis()" << G4endl;
 
@@ -228,15 +376,27 @@ void RunAction::EndOfRunAction(const G4Run*)
     //    -En mono-thread, cela n’a aucun effet néfaste.
 
 
+    FlushLostPrimaries();
+    FlushKilledTracks();
     G4AccumulableManager::Instance()->Merge();
 
-    // Ne logg(er)/écrire/fermer qu’une seule fois (master en MT, sinon SEQ)
+    // [ADD] Espace des phases : en-tête et fermeture du fichier du thread, bilan du rejeu
+    PhaseSpace::EndRun(run);
+
+    // Ne logg(er) le bilan qu’une seule fois (master en MT, sinon SEQ)
     bool isMaster = true;
     #ifdef G4MULTITHREADED
     isMaster = G4Threading::IsMasterThread();
     #endif
 
-    if (isMaster) {
+    if (!isMaster) {
+        // [FIX] Worker MT : Write() transfère histos/ntuples vers le master, puis fermeture
+        am->Write();
+        am->CloseFile(false);
+        return;
+    }
+
+    {
         // (sécurité) s’assurer que l’analyse est bien active pour Write/Close
         if (!am->IsActive()) {
             G4cout << ThreadTag()
@@ -275,7 +435,7 @@ void RunAction::EndOfRunAction(const G4Run*)
             G4double totalEdep = 0.0;
             for (const auto& hit : hits) totalEdep += hit.GetEdep();
 
-            if (fRunVerbose == 1) {
+            if (Diag::Verbose(fRunVerbose)) {
                 G4cout << "→ Event #" << eventID
                 << " : " << hits.size() << " hits, "
                 << "E_dep total = " << totalEdep / keV << " keV" << G4endl;
@@ -290,39 +450,104 @@ void RunAction::EndOfRunAction(const G4Run*)
         << fNValidParticles_gt_35.GetValue() << G4endl;
         G4cout << "=============================================" << G4endl;
 
-        // Compteurs côté Stepping : primaires au plan
-        G4cout << "[STEP][SUMMARY] enter_plane_prim=" << gEnterPlanePrim
-        << " leave_plane_prim=" << gLeavePlanePrim << G4endl;
-
-
-        auto* sdm = G4SDManager::GetSDMpointer();
-        if (auto* sd = dynamic_cast<SurfaceSpectrumSD*>(sdm->FindSensitiveDetector("SpecSD", false))) {
-            sd->PrintSummary();
-
-            // [LOSS] Pertes de primaires avant z=60 mm : ventilation
-            if (!gLostByProc.empty() || !gLostByMat.empty()) {
-                G4cout << "[LOSS][BY-PROC]" << G4endl;
-                for (const auto& kv : gLostByProc) {
-                    G4cout << "  " << kv.first << " : " << kv.second << G4endl;
-                }
-                G4cout << "[LOSS][BY-MAT]" << G4endl;
-                for (const auto& kv : gLostByMat) {
-                    G4cout << "  " << kv.first << " : " << kv.second << G4endl;
-                }
-            } else {
-                G4cout << "[LOSS] no primary lost before z=60 mm (maps empty)" << G4endl;
+        // Compteurs côté Stepping : primaires au plan (accumulables fusionnés)
+        G4cout << "[STEP][SUMMARY] enter_plane_prim=" << fEnterPlanePrim.GetValue()
+        << " leave_plane_prim=" << fLeavePlanePrim.GetValue() << G4endl;
+        G4cout << "[STEP][SUMMARY] transmitted_total=" << fTransmittedTotal.GetValue() << G4endl;
+
+        // [ADD] Transmission pondérée : moyenne par primaire +/- écart-type de la moyenne
+        //       (histoires = événements x primaires par événement, ledger fusionné)
+        {
+            const G4long nHistories = RunLedger::Instance()->Get(Ledger::kHistories);
+            G4double mean = 0., sigma = 0.;
+            HistoryMean(fTransmittedW.GetValue(), fTransmittedW2.GetValue(), nHistories, mean, sigma);
+            G4cout << "[STEP][SUMMARY] transmitted_weighted=" << fTransmittedW.GetValue()
+            << " per_primary=" << mean << " +/- " << sigma
+            << " (" << RelPercent(mean, sigma) << " %)" << G4endl;
+        }
+
+        // [ADD] Bilan SpecSD / ScorePlaneNSD / Stepping : RunLedger fusionné
+        //       (les SD n'existent que sur les workers en MT, leurs compteurs vivent dans le ledger)
+        RunLedger::Instance()->PrintSummary();
+
+        // [ADD] Débit du run : comparaison des variantes SIM_DIAGNOSTICS=ON/OFF (cf. bench.mac)
+        {
+            const G4int nEvents = run ? run->GetNumberOfEvent() : 0;
+            const G4double wall = fRunTimer.GetRealElapsed();
+            G4cout << "[RUN][TIMING] diagnostics=" << Diag::Variant()
+            << " events=" << nEvents
+            << " histories=" << RunLedger::Instance()->Get(Ledger::kHistories)
+            << " wall=" << wall << " s"
+            << " rate=" << (wall > 0. ? nEvents / wall : 0.) << " evt/s"
+            << " peak_rss=" << PeakRSS_MB() << " MB" << G4endl;
+        }
+
+        // [LOSS] Pertes de primaires avant z=60 mm : ventilation
+        if (!fLostByProc.IsEmpty() || !fLostByMat.IsEmpty()) {
+            G4cout << "[LOSS][BY-PROC]" << G4endl;
+            for (const auto& kv : fLostByProc.GetCounts()) {
+                G4cout << "  " << kv.first << " : " << kv.second << G4endl;
+            }
+            G4cout << "[LOSS][BY-MAT]" << G4endl;
+            for (const auto& kv : fLostByMat.GetCounts()) {
+                G4cout << "  " << kv.first << " : " << kv.second << G4endl;
             }
         } else {
-            G4cout << "[WARN] SpecSD not found in SDManager at EndOfRunAction()" << G4endl;
+            G4cout << "[LOSS] no primary lost before z=60 mm (maps empty)" << G4endl;
+        }
+
+        // [KILL] Arrêt géométrique : ventilation par volume quitté et temps économisé.
+        //        Estimation : chaque track arrêté aurait coûté le temps CPU moyen d'un
+        //        track du run (temps CPU du processus, tous threads, / tracks transportés).
+        if (TrackKiller::IsEnabled()) {
+            const auto* ledger = RunLedger::Instance();
+            const G4long killed = ledger->Get(Ledger::kKillBackward)
+                                + ledger->Get(Ledger::kKillSide)
+                                + ledger->Get(Ledger::kKillBeyond);
+            const G4long tracks = ledger->Get(Ledger::kTracks);
+            const G4double cpu = fRunTimer.GetUserElapsed() + fRunTimer.GetSystemElapsed();
+            const G4double perTrack = (tracks > 0) ? cpu / tracks : 0.;
+            G4cout << "[KILL][SUMMARY] killed=" << killed
+                   << " backward=" << ledger->Get(Ledger::kKillBackward)
+                   << " side=" << ledger->Get(Ledger::kKillSide)
+                   << " beyond=" << ledger->Get(Ledger::kKillBeyond)
+                   << " tracks=" << tracks
+                   << " cpu=" << cpu << " s"
+                   << " time_saved_est=" << killed * perTrack << " s" << G4endl;
+            G4cout << "[KILL][BY-VOL] (nombre, énergie cinétique pondérée)" << G4endl;
+            for (const auto& kv : fKilledByVol.GetCounts()) {
+                G4cout << "  " << kv.first << " : " << kv.second
+                       << " | " << fKilledByVol.GetSum(kv.first) << " keV" << G4endl;
+            }
+        }
+
+        // [RANGE] Rejet par la portée : électrons arrêtés et énergie déposée sur place
+        if (RangeRejection::IsEnabled()) {
+            G4cout << "[RANGE][SUMMARY] rejected=" << RunLedger::Instance()->Get(Ledger::kRangeRejected) << G4endl;
+            G4cout << "[RANGE][BY-MAT] (nombre, énergie déposée localement, pondérée)" << G4endl;
+            for (const auto& kv : fRangeRejectedByMat.GetCounts()) {
+                G4cout << "  " << kv.first << " : " << kv.second
+                       << " | " << fRangeRejectedByMat.GetSum(kv.first) << " keV" << G4endl;
+            }
         }
 
+        // [PSF] Espace des phases : particules écrites ou hors format (étape 1), retours arrêtés (étape 2)
+        if (PhaseSpace::IsWriting() || RunLedger::Instance()->Get(Ledger::kPhaseSpaceUpstream) > 0) {
+            G4cout << "[PSF][COUNTS] written=" << RunLedger::Instance()->Get(Ledger::kPhaseSpaceWritten)
+                   << " dropped=" << RunLedger::Instance()->Get(Ledger::kPhaseSpaceDropped)
+                   << " upstream_killed=" << RunLedger::Instance()->Get(Ledger::kPhaseSpaceUpstream) << G4endl;
+        }
+
+        // [DOSE3D] Maillage de dose : blocs fusionnés -> fichier <output>.dose (sans effet si désactivé)
+        fDoseMesh.EndRun();
+
         G4cout << "=======================================================\n";
 
         // ==================== Step Tracking Summary ====================
         G4cout << "\n================================================================================\n"
-               << "FIN DU SUIVI STEP PAR STEP - " << SteppingAction::GetTrackedParticlesCount() 
+               << "FIN DU SUIVI STEP PAR STEP - " << StepTracer::GetTracedCount() 
                << " evenements suivis (max=" 
-               << SteppingAction::GetMaxTrackedParticles() << ")\n"
+               << StepTracer::GetMaxEvents() << ")\n"
                << "================================================================================\n" 
                << G4endl;
         // ===============================================================
@@ -340,33 +565,73 @@ void RunAction::EndOfRunAction(const G4Run*)
         constexpr G4double keV_to_pGy_per_gram = 0.1602;
         
         // H3: Dose totale dans l'eau (run complet) - en pGy
-        G4double dose_total_run_pGy = fTotalEdepWater * keV_to_pGy_per_gram / kMassTotalWater;
+        G4double dose_total_run_pGy = fTotalEdepWater.GetValue() * keV_to_pGy_per_gram / kMassTotalWater;
         am->FillH1(3, dose_total_run_pGy);
         
         // H5-H9: Dose par anneau (run complet) - en pGy
         for (G4int i = 0; i < kNbWaterRings; i++) {
-            G4double dose_ring_run_pGy = fTotalEdepRing[i] * keV_to_pGy_per_gram / kMassRing[i];
+            G4double dose_ring_run_pGy = fTotalEdepRing[i].GetValue() * keV_to_pGy_per_gram / kMassRing[i];
             am->FillH1(5 + i, dose_ring_run_pGy);
         }
         
         // Afficher le résumé des doses (en nGy pour la lisibilité, 1 nGy = 1000 pGy)
         G4double dose_total_run_nGy = dose_total_run_pGy / 1000.0;
         G4cout << "\n==================== RÉSUMÉ DOSE ====================\n";
-        G4cout << "Énergie totale déposée dans l'eau : " << fTotalEdepWater << " keV\n";
+        G4cout << "Énergie totale déposée dans l'eau : " << fTotalEdepWater.GetValue() << " keV\n";
         G4cout << "Dose totale dans l'eau (run)      : " << dose_total_run_pGy << " pGy = " 
                << dose_total_run_nGy << " nGy\n";
         G4cout << "Dose par anneau (run) :\n";
         for (G4int i = 0; i < kNbWaterRings; i++) {
-            G4double dose_ring_pGy = fTotalEdepRing[i] * keV_to_pGy_per_gram / kMassRing[i];
+            G4double dose_ring_pGy = fTotalEdepRing[i].GetValue() * keV_to_pGy_per_gram / kMassRing[i];
             G4double dose_ring_nGy = dose_ring_pGy / 1000.0;
             G4cout << "  Anneau " << i << " (r=" << 2*i << "-" << 2*(i+1) << "mm) : "
-                   << fTotalEdepRing[i] << " keV -> " << dose_ring_pGy << " pGy = " 
+                   << fTotalEdepRing[i].GetValue() << " keV -> " << dose_ring_pGy << " pGy = " 
                    << dose_ring_nGy << " nGy\n";
         }
+
+        // [ADD] Incertitude statistique (1 sigma) par histoire sur les doses pondérées :
+        //       dose = N * moyenne par histoire (valeurs ci-dessus, inchangées),
+        //       sigma = N * écart-type de la moyenne des scores d'histoire
+        //       (N = événements x primaires par événement).
+        //       FOM = 1 / (R^2 * T) avec R l'erreur relative et T le temps réel du run (s) :
+        //       à comparer entre deux jeux d'importances (/importance/) à T égal ou non.
+        {
+            const G4long nEvents = RunLedger::Instance()->Get(Ledger::kHistories);
+            const G4double wall = fRunTimer.GetRealElapsed();
+            G4double mean = 0., sigma = 0.;
+            HistoryMean(fTotalEdepWater.GetValue(), fTotalEdepWater2.GetValue(), nEvents, mean, sigma);
+            G4cout << "Incertitudes (N=" << nEvents << " histoires, 1 sigma) et FOM (T=" << wall << " s) :\n";
+            G4cout << "  Total     : " << dose_total_run_pGy
+                   << " +/- " << nEvents * sigma * keV_to_pGy_per_gram / kMassTotalWater << " pGy"
+                   << " (" << RelPercent(mean, sigma) << " %)"
+                   << " FOM=" << FigureOfMerit(mean, sigma, wall) << " /s\n";
+            for (G4int i = 0; i < kNbWaterRings; i++) {
+                HistoryMean(fTotalEdepRing[i].GetValue(), fTotalEdepRing2[i].GetValue(), nEvents, mean, sigma);
+                G4cout << "  Anneau " << i << "  : " << fTotalEdepRing[i].GetValue() * keV_to_pGy_per_gram / kMassRing[i]
+                       << " +/- " << nEvents * sigma * keV_to_pGy_per_gram / kMassRing[i] << " pGy"
+                       << " (" << RelPercent(mean, sigma) << " %)"
+                       << " FOM=" << FigureOfMerit(mean, sigma, wall) << " /s\n";
+            }
+
+            // [ADD] Estimateur kerma (longueur de trace des photons x mu_en/rho de l'eau) :
+            //       égal à la dose en équilibre électronique, sans les électrons venus
+            //       de l'extérieur de l'anneau ; variance bien plus faible que le dépôt.
+            G4cout << "Kerma par anneau (longueur de trace x mu_en/rho), rapport au dépôt :\n";
+            for (G4int i = 0; i < kNbWaterRings; i++) {
+                HistoryMean(fTotalKermaRing[i].GetValue(), fTotalKermaRing2[i].GetValue(), nEvents, mean, sigma);
+                const G4double kerma_pGy = fTotalKermaRing[i].GetValue() * keV_to_pGy_per_gram / kMassRing[i];
+                const G4double edep = fTotalEdepRing[i].GetValue();
+                G4cout << "  Anneau " << i << "  : " << kerma_pGy
+                       << " +/- " << nEvents * sigma * keV_to_pGy_per_gram / kMassRing[i] << " pGy"
+                       << " (" << RelPercent(mean, sigma) << " %)"
+                       << " FOM=" << FigureOfMerit(mean, sigma, wall) << " /s"
+                       << " | K/Edep=" << ((edep > 0.) ? fTotalKermaRing[i].GetValue() / edep : 0.) << "\n";
+            }
+        }
         G4cout << "=====================================================\n";
         // ====================================================================================
 
-        // 3) Écriture / fermeture du ROOT (une seule fois)
+        // 3) Écriture / fermeture du ROOT (master : fichier fusionné)
         G4cout << ThreadTag() << " [RUN] EndOfRunAction: about to Write()" << G4endl;
         am->Write();
         G4cout << ThreadTag() << " [RUN] EndOfRunAction: Write() done" << G4endl;
@@ -387,7 +652,7 @@ void RunAction::UpdateFromEvent(const EventAction* event)
     //  Sécurité : si le pointeur vers EventAction est nul, on ne fait rien pour éviter un crash.
     if (!event) return;
 
-    if (fRunVerbose== 1) {
+    if (Diag::Verbose(fRunVerbose)) {
         G4cout << " \n[DEBUG RunAction]  " <<  G4endl;
     G4cout << " \n[DEBUG RunAction] AVANT update : fTotalEntrantInBe = " << fTotalEntrantInBe.GetValue() << G4endl;
     G4cout << " \n[DEBUG RunAction] event->GetNbEntrantInBe() = " << event->GetNbEntrantInBe() << G4endl;}
@@ -459,26 +724,57 @@ void RunAction::AddEdepFromEvent(const G4double* edepRing, G4double edepTotal)
     }
     fTotalEdepWater += edepTotal;
     fEdepWater10000 += edepTotal;
+
+    // Carrés des scores d'événement (incertitudes de fin de run)
+    for (G4int i = 0; i < kNbWaterRings; i++) {
+        fTotalEdepRing2[i] += edepRing[i] * edepRing[i];
+    }
+    fTotalEdepWater2 += edepTotal * edepTotal;
+}
+
+void RunAction::AddKermaFromEvent(const G4double* kermaRing)
+{
+    for (G4int i = 0; i < kNbWaterRings; i++) {
+        fTotalKermaRing[i]  += kermaRing[i];
+        fTotalKermaRing2[i] += kermaRing[i] * kermaRing[i];
+        fKermaRing10000[i]  += kermaRing[i];
+    }
+}
+
+void RunAction::FlushEventTransmission()
+{
+    // Primaires sans photon transmis : score nul, rien à ajouter
+    for (G4double& w : fTransmittedWeightEvent) {
+        fTransmittedW  += w;
+        fTransmittedW2 += w * w;
+        w = 0.;
+    }
 }
 
 G4double RunAction::GetTotalEdepRing(G4int ringIndex) const
 {
     if (ringIndex >= 0 && ringIndex < kNbWaterRings) {
-        return fTotalEdepRing[ringIndex];
+        return fTotalEdepRing[ringIndex].GetValue();
     }
     return 0.0;
 }
 
 G4double RunAction::GetTotalEdepWater() const
 {
-    return fTotalEdepWater;
+    return fTotalEdepWater.GetValue();
 }
 
 void RunAction::CheckAndFillDoseHistograms(G4int eventID)
 {
     // Remplir les histogrammes de dose tous les 10000 événements
-    if (eventID > 0 && eventID % 10000 == 0 && eventID != fLastHistoFillEvent) {
-        fLastHistoFillEvent = eventID;
+    // (un appel par primaire, cf. EventAction : lots de 10000 histoires)
+    // [FIX] MT : le lot est compté sur les événements traités PAR CE THREAD
+    //       (les eventID sont distribués entre threads, eventID % 10000 ne
+    //       correspond plus à un lot de 10000 événements du tampon local).
+    //       En SEQ le comportement est inchangé à un événement près (premier lot).
+    ++fEventsInBatch;
+    if (fEventsInBatch >= kEventsPerDoseBatch) {
+        fEventsInBatch = 0;
         
         auto analysisManager = G4AnalysisManager::Instance();
         
@@ -502,9 +798,14 @@ void RunAction::CheckAndFillDoseHistograms(G4int eventID)
             dose_ring[i] = fEdepRing10000[i] * keV_to_pGy_per_gram / kMassRing[i];
             analysisManager->FillH1(10 + i, dose_ring[i]);
         }
+
+        // H15-H19: Kerma par anneau (par 10000 événements), même conversion
+        for (G4int i = 0; i < kNbWaterRings; i++) {
+            analysisManager->FillH1(15 + i, fKermaRing10000[i] * keV_to_pGy_per_gram / kMassRing[i]);
+        }
         
         // ===== AFFICHAGE PROGRESS TOUS LES 10000 ÉVÉNEMENTS =====
-        G4cout << "[PROGRESS] Event " << eventID 
+        G4cout << ThreadTag() << " [PROGRESS] Event " << eventID 
                << " | Transmitted: " << fTransmitted10000
                << " | Edep(keV): Tot=" << fEdepWater10000
                << " R0=" << fEdepRing10000[0]
@@ -523,6 +824,7 @@ void RunAction::CheckAndFillDoseHistograms(G4int eventID)
         // Réinitialiser les accumulateurs pour les prochains 10000 événements
         for (G4int i = 0; i < kNbWaterRings; i++) {
             fEdepRing10000[i] = 0.0;
+            fKermaRing10000[i] = 0.0;
         }
         fEdepWater10000 = 0.0;
         fTransmitted10000 = 0;
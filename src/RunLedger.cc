@@ -0,0 +1,65 @@
+#include "RunLedger.hh"
+
+RunLedger* RunLedger::Instance()
+{
+    // Une instance par thread, jamais partagée : aucun verrou nécessaire.
+    // (durée de vie = celle du thread, comme les autres singletons G4ThreadLocal)
+    static G4ThreadLocal RunLedger* instance = nullptr;
+    if (!instance) instance = new RunLedger("RunLedger");
+    return instance;
+}
+
+void RunLedger::Merge(const G4VAccumulable& other)
+{
+    const auto& rhs = static_cast<const RunLedger&>(other);
+    for (G4int i = 0; i < Ledger::kNbSlots; ++i) {
+        fCounts[i] += rhs.fCounts[i];
+    }
+}
+
+void RunLedger::Reset()
+{
+    fCounts.fill(0);
+}
+
+void RunLedger::PrintPlaneSummary(const char* sdName, G4int base) const
+{
+    G4cout << "[" << sdName << "][SUMMARY]"
+           << " total="    << Get(Ledger::PlaneSlot(base, Ledger::kPlaneTotal))
+           << " accepted=" << Get(Ledger::PlaneSlot(base, Ledger::kPlaneAccepted))
+           << " rejected=" << Get(Ledger::PlaneSlot(base, Ledger::kPlaneRejected))
+           << G4endl;
+}
+
+void RunLedger::PrintSummary() const
+{
+    G4cout << "[SpecSD][SUMMARY] enter=" << Get(Ledger::kSpecEnter)
+           << " leave=" << Get(Ledger::kSpecLeave)
+           << " outward=" << Get(Ledger::kSpecOut)
+           << " rows_written=" << Get(Ledger::kSpecRows)
+           << " unique_primary_events_counted=" << Get(Ledger::kSpecPrimaryEvents)
+           << " compton_redirected=" << Get(Ledger::kSpecComptonRedirected)
+           << " secondaries=" << Get(Ledger::kSpecSecondaries)
+           << G4endl;
+
+    PrintPlaneSummary("ScorePlane2SD", Ledger::kScorePlane2Base);
+    PrintPlaneSummary("ScorePlane3SD", Ledger::kScorePlane3Base);
+    PrintPlaneSummary("ScorePlane4SD", Ledger::kScorePlane4Base);
+    PrintPlaneSummary("ScorePlane5SD", Ledger::kScorePlane5Base);
+
+    G4cout << "[STEP][SUMMARY] compton_in_cone=" << Get(Ledger::kComptonInCone)
+           << " abs_graphite=" << Get(Ledger::kAbsGraphite)
+           << " abs_inox=" << Get(Ledger::kAbsInox)
+           << G4endl;
+
+    G4cout << "[TRACK][SUMMARY] trajectories_stored=" << Get(Ledger::kTrajectoriesStored)
+           << " tracks=" << Get(Ledger::kTracks)
+           << G4endl;
+}
+
+#if G4VERSION_NUMBER >= 1130
+void RunLedger::Print(G4PrintOptions) const
+{
+    PrintSummary();
+}
+#endif
@@ -1,4 +1,8 @@
 #include "ScorePlane2SD.hh"
+#include "RunLedger.hh"
+#include "Diagnostics.hh"
+#include "PlaneTallies.hh"
+#include "MyTrackInfo.hh"
 
 #include "G4Step.hh"
 #include "G4Track.hh"
@@ -20,10 +24,14 @@ namespace {
         return "[SEQ]";
 #endif
     }
+
+    // Slot RunLedger d'un champ de ce plan
+    constexpr G4int Slot(Ledger::PlaneField f) { return Ledger::PlaneSlot(Ledger::kScorePlane2Base, f); }
 }
 
 ScorePlane2SD::ScorePlane2SD(const G4String& name)
     : G4VSensitiveDetector(name)
+    , fLedger(RunLedger::Instance())
 {
     G4cout << ThreadTag() << " [ScorePlane2SD] Constructeur: " << name << G4endl;
 }
@@ -33,13 +41,10 @@ void ScorePlane2SD::Initialize(G4HCofThisEvent*)
     // Reset du set de tracks pour ce nouvel événement
     fTracksThisEvent.clear();
     
-    auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
-    G4int eid = ev ? ev->GetEventID() : -1;
-    
-    static int dbg = 0;
-    if (dbg < 5) {
+    if (Diag::First(fLedger, Slot(Ledger::kPlaneLogInit), 5)) {
+        auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
+        G4int eid = ev ? ev->GetEventID() : -1;
         G4cout << ThreadTag() << " [ScorePlane2SD] Initialize event " << eid << G4endl;
-        ++dbg;
     }
 }
 
@@ -55,7 +60,7 @@ G4bool ScorePlane2SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     if (!preStep || !postStep) return false;
 
     // Compteur total
-    ++fCntTotal;
+    fLedger->Add(Slot(Ledger::kPlaneTotal));
 
     // Vérifier qu'on ENTRE dans le volume (preStep hors du volume, postStep dans le volume)
     // ou qu'on est au premier step dans le volume
@@ -81,11 +86,9 @@ G4bool ScorePlane2SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     // Vérifier la direction : on ne garde que les particules allant vers +Z
     const G4ThreeVector& dir = preStep->GetMomentumDirection();
     if (dir.z() <= 0.) {
-        ++fCntRejected;
-        static int dbg_reject = 0;
-        if (dbg_reject < 10) {
+        fLedger->Add(Slot(Ledger::kPlaneRejected));
+        if (Diag::First(fLedger, Slot(Ledger::kPlaneLogReject), 10)) {
             G4cout << "[ScorePlane2SD] REJECT (dir.z <= 0): dir.z=" << dir.z() << G4endl;
-            ++dbg_reject;
         }
         return false;
     }
@@ -98,28 +101,20 @@ G4bool ScorePlane2SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     }
     fTracksThisEvent.insert(trackID);
 
-    ++fCntAccepted;
+    fLedger->Add(Slot(Ledger::kPlaneAccepted));
 
     // Récupérer les informations à enregistrer
     const G4ParticleDefinition* def = track->GetDefinition();
     const G4int pdg = def ? def->GetPDGEncoding() : 0;
-    const G4String name = def ? def->GetParticleName() : "unknown";
     
     // is_secondary : 0 = primaire, 1 = secondaire
-    // ParentID == 0 signifie que c'est une particule primaire
+    // ParentID == 0, ou clone forced collision d'un primaire (MyTrackInfo::IsPrimary)
     const G4int parentID = track->GetParentID();
-    const G4int is_secondary = (parentID == 0) ? 0 : 1;
+    const G4int is_secondary = MyTrackInfo::IsPrimary(track) ? 0 : 1;
     
     // TrackID
     const G4int trackIDval = track->GetTrackID();
     
-    // Processus créateur (pour les secondaires)
-    const G4VProcess* creatorProcess = track->GetCreatorProcess();
-    G4String creator_process = "primary";
-    if (creatorProcess) {
-        creator_process = creatorProcess->GetProcessName();
-    }
-
     // Position à l'entrée (preStep ou postStep selon le cas)
     G4ThreeVector pos;
     if (enteringVolume) {
@@ -133,10 +128,20 @@ G4bool ScorePlane2SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     // Énergie cinétique à l'entrée
     const G4double ekin_keV = preStep->GetKineticEnergy() / keV;
 
-    // Écriture dans le ntuple
-    if (fNtupleId >= 0) {
+    // Tallies binnés (/tallies/mode tallies|both)
+    if (PlaneTallies::FillTallies()) {
+        PlaneTallies::Fill(PlaneTallies::kScorePlane2, track, x_mm, y_mm, ekin_keV);
+    }
+
+    // Écriture dans le ntuple (/tallies/mode ntuple|both)
+    if (fNtupleId >= 0 && PlaneTallies::WriteRows()) {
         auto* man = G4AnalysisManager::Instance();
         if (man && man->IsActive()) {
+            // Chaînes construites seulement pour les lignes du ntuple
+            const G4String name = def ? def->GetParticleName() : "unknown";
+            const G4VProcess* creatorProcess = track->GetCreatorProcess();
+            const G4String creator_process = creatorProcess ? creatorProcess->GetProcessName() : "primary";
+
             man->FillNtupleIColumn(fNtupleId, 0, pdg);
             man->FillNtupleSColumn(fNtupleId, 1, name);
             man->FillNtupleIColumn(fNtupleId, 2, is_secondary);
@@ -146,11 +151,11 @@ G4bool ScorePlane2SD::ProcessHits(G4Step* step, G4TouchableHistory*)
             man->FillNtupleIColumn(fNtupleId, 6, trackIDval);
             man->FillNtupleIColumn(fNtupleId, 7, parentID);
             man->FillNtupleSColumn(fNtupleId, 8, creator_process);
+            man->FillNtupleDColumn(fNtupleId, 9, track->GetWeight());
             man->AddNtupleRow(fNtupleId);
 
             // Debug log (limité)
-            static int dbg_write = 0;
-            if (dbg_write < 20) {
+            if (Diag::First(fLedger, Slot(Ledger::kPlaneLogWrite), 20)) {
                 G4cout << "[ScorePlane2SD] WROTE row: pdg=" << pdg 
                        << " name=" << name
                        << " is_secondary=" << is_secondary
@@ -161,7 +166,6 @@ G4bool ScorePlane2SD::ProcessHits(G4Step* step, G4TouchableHistory*)
                        << " parentID=" << parentID
                        << " creator=" << creator_process
                        << G4endl;
-                ++dbg_write;
             }
         }
     }
@@ -171,25 +175,22 @@ G4bool ScorePlane2SD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
 void ScorePlane2SD::EndOfEvent(G4HCofThisEvent*)
 {
-    auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
-    G4int eid = ev ? ev->GetEventID() : -1;
-    
-    static int dbg = 0;
-    if (dbg < 5 || fTracksThisEvent.size() > 0) {
-        if (dbg < 20) {
+    if constexpr (Diag::kEnabled) {
+        auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
+        G4int eid = ev ? ev->GetEventID() : -1;
+
+        const G4long dbg = fLedger->Get(Slot(Ledger::kPlaneLogEnd));
+        if (dbg < 20 && (dbg < 5 || !fTracksThisEvent.empty())) {
+            fLedger->Add(Slot(Ledger::kPlaneLogEnd));
             G4cout << ThreadTag() << " [ScorePlane2SD] EndOfEvent " << eid 
                    << ": " << fTracksThisEvent.size() << " particules enregistrées"
                    << G4endl;
-            ++dbg;
         }
     }
 }
 
 void ScorePlane2SD::PrintSummary() const
 {
-    G4cout << "[ScorePlane2SD][SUMMARY]"
-           << " total=" << fCntTotal
-           << " accepted=" << fCntAccepted
-           << " rejected=" << fCntRejected
-           << G4endl;
+    // Compteurs du thread courant (bilan fusionné : RunLedger::PrintSummary() sur le master)
+    fLedger->PrintPlaneSummary("ScorePlane2SD", Ledger::kScorePlane2Base);
 }
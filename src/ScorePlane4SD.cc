@@ -1,4 +1,8 @@
 #include "ScorePlane4SD.hh"
+#include "RunLedger.hh"
+#include "Diagnostics.hh"
+#include "PlaneTallies.hh"
+#include "MyTrackInfo.hh"
 
 #include "G4Step.hh"
 #include "G4Track.hh"
@@ -20,6 +24,9 @@ namespace {
         return "[SEQ]";
 #endif
     }
+
+    // Slot RunLedger d'un champ de ce plan
+    constexpr G4int Slot(Ledger::PlaneField f) { return Ledger::PlaneSlot(Ledger::kScorePlane4Base, f); }
     
     // ===========================================================================
     // CORRECTION : Fonction pour vérifier si le nom correspond à un WaterRing
@@ -32,6 +39,7 @@ namespace {
 
 ScorePlane4SD::ScorePlane4SD(const G4String& name)
     : G4VSensitiveDetector(name)
+    , fLedger(RunLedger::Instance())
 {
     G4cout << ThreadTag() << " [ScorePlane4SD] Constructeur: " << name << G4endl;
 }
@@ -40,13 +48,10 @@ void ScorePlane4SD::Initialize(G4HCofThisEvent*)
 {
     fTracksThisEvent.clear();
     
-    auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
-    G4int eid = ev ? ev->GetEventID() : -1;
-    
-    static int dbg = 0;
-    if (dbg < 5) {
+    if (Diag::First(fLedger, Slot(Ledger::kPlaneLogInit), 5)) {
+        auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
+        G4int eid = ev ? ev->GetEventID() : -1;
         G4cout << ThreadTag() << " [ScorePlane4SD] Initialize event " << eid << G4endl;
-        ++dbg;
     }
 }
 
@@ -61,7 +66,7 @@ G4bool ScorePlane4SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     const G4StepPoint* postStep = step->GetPostStepPoint();
     if (!preStep || !postStep) return false;
 
-    ++fCntTotal;
+    fLedger->Add(Slot(Ledger::kPlaneTotal));
 
     const G4VPhysicalVolume* prePV = preStep->GetPhysicalVolume();
     const G4VPhysicalVolume* postPV = postStep->GetPhysicalVolume();
@@ -86,7 +91,7 @@ G4bool ScorePlane4SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     // Filtrer : accepter uniquement les particules allant vers +z
     const G4ThreeVector& dir = preStep->GetMomentumDirection();
     if (dir.z() <= 0.) {
-        ++fCntRejected;
+        fLedger->Add(Slot(Ledger::kPlaneRejected));
         return false;
     }
 
@@ -97,23 +102,16 @@ G4bool ScorePlane4SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     }
     fTracksThisEvent.insert(trackID);
 
-    ++fCntAccepted;
+    fLedger->Add(Slot(Ledger::kPlaneAccepted));
 
     // Récupération des informations de la particule
     const G4ParticleDefinition* def = track->GetDefinition();
     const G4int pdg = def ? def->GetPDGEncoding() : 0;
-    const G4String name = def ? def->GetParticleName() : "unknown";
     
     const G4int parentID = track->GetParentID();
-    const G4int is_secondary = (parentID == 0) ? 0 : 1;
+    const G4int is_secondary = MyTrackInfo::IsPrimary(track) ? 0 : 1;
     const G4int trackIDval = track->GetTrackID();
     
-    const G4VProcess* creatorProcess = track->GetCreatorProcess();
-    G4String creator_process = "primary";
-    if (creatorProcess) {
-        creator_process = creatorProcess->GetProcessName();
-    }
-
     // Position
     G4ThreeVector pos;
     if (enteringVolume) {
@@ -126,10 +124,20 @@ G4bool ScorePlane4SD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
     const G4double ekin_keV = preStep->GetKineticEnergy() / keV;
 
-    // Écriture dans le ntuple
-    if (fNtupleId >= 0) {
+    // Tallies binnés (/tallies/mode tallies|both)
+    if (PlaneTallies::FillTallies()) {
+        PlaneTallies::Fill(PlaneTallies::kWaterRings, track, x_mm, y_mm, ekin_keV);
+    }
+
+    // Écriture dans le ntuple (/tallies/mode ntuple|both)
+    if (fNtupleId >= 0 && PlaneTallies::WriteRows()) {
         auto* man = G4AnalysisManager::Instance();
         if (man && man->IsActive()) {
+            // Chaînes construites seulement pour les lignes du ntuple
+            const G4String name = def ? def->GetParticleName() : "unknown";
+            const G4VProcess* creatorProcess = track->GetCreatorProcess();
+            const G4String creator_process = creatorProcess ? creatorProcess->GetProcessName() : "primary";
+
             man->FillNtupleIColumn(fNtupleId, 0, pdg);
             man->FillNtupleSColumn(fNtupleId, 1, name);
             man->FillNtupleIColumn(fNtupleId, 2, is_secondary);
@@ -139,10 +147,10 @@ G4bool ScorePlane4SD::ProcessHits(G4Step* step, G4TouchableHistory*)
             man->FillNtupleIColumn(fNtupleId, 6, trackIDval);
             man->FillNtupleIColumn(fNtupleId, 7, parentID);
             man->FillNtupleSColumn(fNtupleId, 8, creator_process);
+            man->FillNtupleDColumn(fNtupleId, 9, track->GetWeight());
             man->AddNtupleRow(fNtupleId);
 
-            static int dbg_write = 0;
-            if (dbg_write < 20) {
+            if (Diag::First(fLedger, Slot(Ledger::kPlaneLogWrite), 20)) {
                 G4cout << "[ScorePlane4SD] WROTE row: pdg=" << pdg 
                        << " name=" << name
                        << " is_secondary=" << is_secondary
@@ -151,7 +159,6 @@ G4bool ScorePlane4SD::ProcessHits(G4Step* step, G4TouchableHistory*)
                        << " Ekin=" << ekin_keV << " keV"
                        << " volume=" << (enteringVolume ? postName : preName)
                        << G4endl;
-                ++dbg_write;
             }
         }
     }
@@ -161,25 +168,22 @@ G4bool ScorePlane4SD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
 void ScorePlane4SD::EndOfEvent(G4HCofThisEvent*)
 {
-    auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
-    G4int eid = ev ? ev->GetEventID() : -1;
-    
-    static int dbg = 0;
-    if (dbg < 5 || fTracksThisEvent.size() > 0) {
-        if (dbg < 20) {
+    if constexpr (Diag::kEnabled) {
+        auto ev = G4RunManager::GetRunManager()->GetCurrentEvent();
+        G4int eid = ev ? ev->GetEventID() : -1;
+
+        const G4long dbg = fLedger->Get(Slot(Ledger::kPlaneLogEnd));
+        if (dbg < 20 && (dbg < 5 || !fTracksThisEvent.empty())) {
+            fLedger->Add(Slot(Ledger::kPlaneLogEnd));
             G4cout << ThreadTag() << " [ScorePlane4SD] EndOfEvent " << eid 
                    << ": " << fTracksThisEvent.size() << " particules enregistrées"
                    << G4endl;
-            ++dbg;
         }
     }
 }
 
 void ScorePlane4SD::PrintSummary() const
 {
-    G4cout << "[ScorePlane4SD][SUMMARY]"
-           << " total=" << fCntTotal
-           << " accepted=" << fCntAccepted
-           << " rejected=" << fCntRejected
-           << G4endl;
+    // Compteurs du thread courant (bilan fusionné : RunLedger::PrintSummary() sur le master)
+    fLedger->PrintPlaneSummary("ScorePlane4SD", Ledger::kScorePlane4Base);
 }
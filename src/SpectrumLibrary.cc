@@ -0,0 +1,138 @@
+#include "SpectrumLibrary.hh"
+#include "SpectrumLibraryMessenger.hh"
+#include "PrimaryGeneratorAction2.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+    G4Mutex gLibraryMutex = G4MUTEX_INITIALIZER;
+
+    // Valeur d'une clé de commentaire "# clé: valeur" (chaîne vide sinon)
+    G4bool ParseKey(const std::string& line, const std::string& key, std::string& value)
+    {
+        const auto pos = line.find(key + ":");
+        if (pos == std::string::npos) return false;
+        value = line.substr(pos + key.size() + 1);
+        const auto first = value.find_first_not_of(" \t");
+        const auto last  = value.find_last_not_of(" \t\r");
+        value = (first == std::string::npos) ? "" : value.substr(first, last - first + 1);
+        return true;
+    }
+}
+
+// ==================== Bibliothèque partagée ====================
+std::map<std::string, std::unique_ptr<SpectrumLibrary::Entry>> SpectrumLibrary::fEntries;
+SpectrumLibraryMessenger* SpectrumLibrary::fMessenger = nullptr;
+
+void SpectrumLibrary::Init()
+{
+    // Tables communes à tous les threads : chargées une seule fois (master / SEQ)
+    if (!G4Threading::IsMasterThread() || fMessenger) return;
+    fMessenger = new SpectrumLibraryMessenger();
+
+    // Tous les spectrum_*.dat du répertoire courant, par ordre alphabétique
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& item : std::filesystem::directory_iterator(".", ec)) {
+        const auto fname = item.path().filename().string();
+        if (item.is_regular_file(ec) && fname.rfind("spectrum_", 0) == 0 &&
+            item.path().extension() == ".dat") {
+            files.push_back(fname);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto& file : files) Load(file);
+    Print();
+}
+
+G4bool SpectrumLibrary::Load(const G4String& file)
+{
+    // Nom : fichier sans répertoire, sans préfixe "spectrum_" ni extension
+    std::string name = std::filesystem::path(std::string(file)).stem().string();
+    if (name.rfind("spectrum_", 0) == 0) name = name.substr(9);
+
+    std::ifstream in(file);
+    if (!in) {
+        G4ExceptionDescription ed;
+        ed << "Spectre " << file << " introuvable : ignoré.";
+        G4Exception("SpectrumLibrary::Load", "SPEC001", JustWarning, ed);
+        return false;
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->file = file;
+
+    std::vector<G4double> x, y;
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+        if (line[first] == '#') {
+            std::string value;
+            if (ParseKey(line, "kVp", value)) entry->kVp = std::atof(value.c_str());
+            else if (ParseKey(line, "filter", value)) entry->filter = value;
+            continue;
+        }
+        std::istringstream iss(line);
+        G4double e = 0., w = 0.;
+        if (!(iss >> e >> w) || w < 0. || (!x.empty() && e*keV <= x.back())) {
+            G4ExceptionDescription ed;
+            ed << file << " : ligne invalide (E croissantes, intensités >= 0) : \"" << line << "\"";
+            G4Exception("SpectrumLibrary::Load", "SPEC002", JustWarning, ed);
+            return false;
+        }
+        x.push_back(e*keV);
+        y.push_back(w);
+    }
+
+    entry->nPoints = x.size();
+    entry->sampler.Build(x, y, PrimaryGeneratorAction2::kEcut);
+    if (entry->sampler.Empty()) {
+        G4ExceptionDescription ed;
+        ed << file << " : aucune intensité au-dessus de "
+           << PrimaryGeneratorAction2::kEcut/keV << " keV, spectre ignoré.";
+        G4Exception("SpectrumLibrary::Load", "SPEC003", JustWarning, ed);
+        return false;
+    }
+
+    G4AutoLock lock(&gLibraryMutex);
+    if (fEntries.count(name)) {
+        G4ExceptionDescription ed;
+        ed << "Spectre \"" << name << "\" déjà chargé : " << file << " ignoré.";
+        G4Exception("SpectrumLibrary::Load", "SPEC004", JustWarning, ed);
+        return false;
+    }
+    fEntries[name] = std::move(entry);
+    return true;
+}
+
+const SpectrumLibrary::Entry* SpectrumLibrary::Find(const G4String& name)
+{
+    G4AutoLock lock(&gLibraryMutex);
+    const auto it = fEntries.find(name);
+    return (it != fEntries.end()) ? it->second.get() : nullptr;
+}
+
+void SpectrumLibrary::Print()
+{
+    G4AutoLock lock(&gLibraryMutex);
+    G4cout << "[SPEC] Spectres chargés : " << fEntries.size()
+           << " (+ builtin), tronqués à E > " << PrimaryGeneratorAction2::kEcut/keV << " keV" << G4endl;
+    for (const auto& kv : fEntries) {
+        const auto& e = *kv.second;
+        G4cout << "  " << e.name << " : " << e.file << " | " << e.nPoints << " points";
+        if (e.kVp > 0.) G4cout << " | " << e.kVp << " kVp";
+        if (!e.filter.empty()) G4cout << " | filtre " << e.filter;
+        G4cout << " | <E>=" << e.sampler.Mean()/keV << " keV" << G4endl;
+    }
+}
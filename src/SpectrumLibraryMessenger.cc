@@ -0,0 +1,41 @@
+#include "SpectrumLibraryMessenger.hh"
+#include "SpectrumLibrary.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : les tables sont partagées
+//  par tous les threads, les commandes ne sont donc pas retransmises.
+SpectrumLibraryMessenger::SpectrumLibraryMessenger()
+{
+    fDir = new G4UIdirectory("/spectra/");
+    fDir->SetGuidance("Bibliothèque de spectres de tube (fichiers .dat), source 2.");
+
+    fLoadCmd = new G4UIcmdWithAString("/spectra/load", this);
+    fLoadCmd->SetGuidance("Charge un spectre tabulé (nom = fichier sans spectrum_ ni .dat).");
+    fLoadCmd->SetParameterName("file", false);
+    fLoadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fLoadCmd->SetToBeBroadcasted(false);
+
+    fListCmd = new G4UIcmdWithoutParameter("/spectra/list", this);
+    fListCmd->SetGuidance("Affiche les spectres chargés.");
+    fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fListCmd->SetToBeBroadcasted(false);
+}
+
+SpectrumLibraryMessenger::~SpectrumLibraryMessenger()
+{
+    delete fLoadCmd;
+    delete fListCmd;
+    delete fDir;
+}
+
+void SpectrumLibraryMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fLoadCmd) {
+        if (SpectrumLibrary::Load(value)) SpectrumLibrary::Print();
+    } else if (command == fListCmd) {
+        SpectrumLibrary::Print();
+    }
+}
@@ -0,0 +1,48 @@
+#include "SpectrumSampler.hh"
+
+#include <algorithm>
+
+void SpectrumSampler::Build(const std::vector<G4double>& x, const std::vector<G4double>& y,
+                            G4double xMin, G4double xMax)
+{
+    fX0.clear(); fWidth.clear(); fY0.clear(); fY1.clear();
+    fIntegral = 0.;
+
+    std::vector<G4double> areas;
+    const std::size_t n = std::min(x.size(), y.size());
+    for (std::size_t j = 0; j + 1 < n; ++j) {
+        G4double xa = x[j], xb = x[j + 1];
+        if (!(xb > xa)) continue;
+        const G4double slope = (y[j + 1] - y[j]) / (xb - xa);
+
+        // Restriction à ]xMin, xMax] : y interpolé aux bornes coupées
+        const G4double a = std::max(xa, xMin);
+        const G4double b = std::min(xb, xMax);
+        if (!(b > a)) continue;
+        const G4double ya = std::max(0., y[j] + slope*(a - xa));
+        const G4double yb = std::max(0., y[j] + slope*(b - xa));
+        const G4double area = 0.5*(ya + yb)*(b - a);
+        if (!(area > 0.)) continue;
+
+        fX0.push_back(a);
+        fWidth.push_back(b - a);
+        fY0.push_back(ya);
+        fY1.push_back(yb);
+        areas.push_back(area);
+        fIntegral += area;
+    }
+    fAlias.Build(areas);
+}
+
+G4double SpectrumSampler::Mean() const
+{
+    // Moment d'ordre 1 de chaque trapèze : w^2 (y0 + 2 y1) / 6 au-delà de x0
+    if (!(fIntegral > 0.)) return 0.;
+    G4double m = 0.;
+    for (std::size_t i = 0; i < fX0.size(); ++i) {
+        const G4double w = fWidth[i];
+        const G4double area = 0.5*(fY0[i] + fY1[i])*w;
+        m += fX0[i]*area + w*w*(fY0[i] + 2.*fY1[i])/6.;
+    }
+    return m / fIntegral;
+}
@@ -1,6 +1,7 @@
 #include "SphereSurfaceSD.hh"
 #include "SphereSurfaceSDMessenger.hh"
 #include "SphereHit.hh"
+#include "Diagnostics.hh"
 
 #include "G4Step.hh"
 #include "G4Track.hh"
@@ -153,19 +154,19 @@ G4bool SphereSurfaceSD::ProcessHits(G4Step* step, G4TouchableHistory*) {
         G4cerr << "[ERREUR] analysisManager est NULL !" << G4endl;
         return true;
     }
-    if (fSDVerboseLevel == 1) {}
+    if (Diag::Verbose(fSDVerboseLevel)) {}
     // Détection d’une sortie de la sphère (entrée non détectée ici)
     // Si une particule sort de logicsphereWater,
     // On enregistre son énergie dans un histogramme (ID 1).
 
     if (namePre == "logicsphereWater" && namePost != "logicsphereWater") {
-        if (fSDVerboseLevel == 1) {
+        if (Diag::Verbose(fSDVerboseLevel)) {
             G4cout << "[DEBUG ProcessHits] ← Sortie de la sphère à E = "<<energy/MeV<<" MeV"<< G4endl;}
         // [SUPPRIMÉ] analysisManager->FillH1(1, energy);
     }
 
     auto edep = step->GetTotalEnergyDeposit();
-    if (fSDVerboseLevel == 1) {
+    if (Diag::Verbose(fSDVerboseLevel)) {
         G4cout <<"[DEBUG ProcessHits][ProcessHits] ← Energie deposee dans la sphère= "<<edep/MeV<<" MeV"<<G4endl;}
 
     //pname contient le nom de la particule en cours de step
@@ -225,7 +226,7 @@ G4bool SphereSurfaceSD::ProcessHits(G4Step* step, G4TouchableHistory*) {
     }
 
     G4int evt = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-   if (fSDVerboseLevel == 1) {
+   if (Diag::Verbose(fSDVerboseLevel)) {
        G4cout << "\n[DEBUG ProcessHits] "<<evt<<G4endl;
         G4cout << "\n[DEBUG ProcessHits] Hits position"<<step->GetPreStepPoint()->GetPosition()<<G4endl;
         G4cout << "\n[DEBUG ProcessHits] edep"<< edep<<G4endl;
@@ -236,7 +237,7 @@ G4bool SphereSurfaceSD::ProcessHits(G4Step* step, G4TouchableHistory*) {
     // qui sera enregistrée dans EventAction.
     fHitsCollection->insert(hit);
 
-    if (fSDVerboseLevel == 1) {
+    if (Diag::Verbose(fSDVerboseLevel)) {
         G4cout << "[DEBUG ProcessHits] Fin OK" << G4endl;}
     return true;
 }
@@ -250,7 +251,7 @@ void SphereSurfaceSD::EndOfEvent(G4HCofThisEvent*) {
     // .entries() renvoie le nombre de SphereHit enregistrés pendant cet événement.
     // Nombre de hits enregistrés
     G4int Nentries = fHitsCollection->entries();
-    if (fSDVerboseLevel == 1) {
+    if (Diag::Verbose(fSDVerboseLevel)) {
         G4cout << "[DEBUG End Of Event] Nentries = "<<Nentries<< G4endl;}
 
     //  Boucle sur tous les hits
@@ -258,7 +259,7 @@ void SphereSurfaceSD::EndOfEvent(G4HCofThisEvent*) {
         // parcourt chaque SphereHit enregistré dans cet événement.
         // i est simplement l’index dans le tableau.
 
-        if (fSDVerboseLevel == 1) {
+        if (Diag::Verbose(fSDVerboseLevel)) {
             G4cout << "[DEBUG End Of Event] i = "<<i<< G4endl;
             // Affichage du hit
         //  appelle la méthode Print() sur le hit correspondant
@@ -0,0 +1,842 @@
+#include "StepObservers.hh"
+
+#include "EventAction.hh"
+#include "RunAction.hh"
+#include "RunLedger.hh"
+#include "MyTrackInfo.hh"
+#include "ProcessRoles.hh"
+#include "AnalysisManagerSetup.hh"
+#include "Diagnostics.hh"
+#include "TrackKiller.hh"
+#include "RangeRejection.hh"
+#include "PhaseSpace.hh"
+#include "DoseMesh.hh"
+#include "WaterMuEn.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4RunManager.hh"
+#include "G4Event.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4VProcess.hh"
+#include "G4BiasingProcessInterface.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4LossTableManager.hh"
+#include "G4SafetyHelper.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4AffineTransform.hh"
+#include "G4VSolid.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+    // Nom du volume logique d'un point de step (logs / colonnes "volume")
+    inline const G4String& LVName(const G4StepPoint* p) {
+        static const G4String kNone = "OutOfWorld";
+        const auto* pv = p ? p->GetPhysicalVolume() : nullptr;
+        return pv ? pv->GetLogicalVolume()->GetName() : kNone;
+    }
+
+    inline const G4String& MatName(const G4StepPoint* p) {
+        static const G4String kNull = "null";
+        const auto* pv = p ? p->GetPhysicalVolume() : nullptr;
+        const auto* mat = pv ? pv->GetLogicalVolume()->GetMaterial() : nullptr;
+        return mat ? mat->GetName() : kNull;
+    }
+
+    // Logs des secondaires d'un step (verbose uniquement)
+    void PrintSecondaries(const G4Step* step)
+    {
+        const auto* secondaries = step->GetSecondaryInCurrentStep();
+        if (!secondaries || secondaries->empty()) return;
+        G4cout << "[DEBUG SteppingAction] → Secondaires produits : " << secondaries->size() << G4endl;
+        for (const auto* sec : *secondaries) {
+            G4cout << "[DEBUG SteppingAction]   ↪ " << sec->GetParticleDefinition()->GetParticleName()
+                   << ", E = " << sec->GetKineticEnergy()/keV << " keV"
+                   << ", créé par : "
+                   << (sec->GetCreatorProcess() ? sec->GetCreatorProcess()->GetProcessName() : "N/A")
+                   << G4endl;
+        }
+    }
+
+    // Photon primaire, ou clone d'un primaire par le biais forced collision
+    inline G4bool IsPrimaryPhoton(const StepContext& ctx) {
+        return ctx.track->GetParentID() == 0 || ctx.trackInfo->IsBiasClone();
+    }
+
+    inline G4int CurrentEventID() {
+        const auto* rm = G4RunManager::GetRunManager();
+        return (rm && rm->GetCurrentEvent()) ? rm->GetCurrentEvent()->GetEventID() : -1;
+    }
+}
+
+// ============================================================================
+// Registre
+// ============================================================================
+StepObserver* StepObserverRegistry::Register(StepObserver* obs, std::initializer_list<G4int> roles)
+{
+    fOwned.emplace_back(obs);
+    if (roles.size() == 0) {
+        fAlways.push_back(obs);
+        return obs;
+    }
+    for (const G4int role : roles) {
+        if (role <= VolumeRole::kOther || role >= VolumeRole::kNbRoles) continue;
+        if (obs->fRoleMask & (1 << role)) continue;
+        obs->fRoleMask |= (1 << role);
+        fByRole[role].push_back(obs);
+    }
+    return obs;
+}
+
+void StepObserverRegistry::Clear()
+{
+    fAlways.clear();
+    for (auto& list : fByRole) list.clear();
+    fOwned.clear();
+}
+
+void StepObserverRegistry::Print() const
+{
+    G4cout << "[STEP][OBSERVERS]";
+    for (G4int role = 0; role < VolumeRole::kNbRoles; ++role) {
+        for (const auto* obs : fByRole[role]) {
+            G4cout << " " << VolumeRoles::RoleName(role) << ":" << obs->GetName();
+        }
+    }
+    for (const auto* obs : fAlways) G4cout << " *:" << obs->GetName();
+    G4cout << G4endl;
+}
+
+// ============================================================================
+// Fenêtre Be (MiniX-TubeXFenetreBeryllium-Beryllium)
+// ============================================================================
+void BeWindowObserver::OnStep(const StepContext& ctx)
+{
+    const bool preIsBe  = (ctx.preInfo.role  == VolumeRole::kBeWindow);
+    const bool postIsBe = (ctx.postInfo.role == VolumeRole::kBeWindow);
+    const G4Track* track = ctx.track;
+
+    //  Entrée : la particule n'était pas dans le Be avant le step et s'y trouve après
+    if (!preIsBe && postIsBe) {
+        fEventAction->IncrementNbEntrantInBe();
+
+        if (Diag::Verbose(fVerbose)) {
+            const G4double energy = track->GetKineticEnergy();
+            G4cout << "🔸[DEBUG SteppingAction] Une particule entre dans MiniX-TubeXFenetreBeryllium-Beryllium !" << G4endl;
+            G4cout << " \n[DEBUG SteppingAction] energy = " << energy/keV << G4endl;
+
+            auto runAction = static_cast<const RunAction*>(G4RunManager::GetRunManager()->GetUserRunAction());
+            if (runAction) {
+                G4cout << "[DEBUG SteppingAction] Entrée Béryllium : courant = "
+                       << fEventAction->GetNbEntrantInBe()
+                       << ", total global = " << runAction->GetTotalEntrantInBe() << G4endl;
+            }
+            G4cout << "[DEBUG SteppingAction]" << "→ Position input :" << ctx.post->GetPosition()/mm << "mm" << G4endl;
+            G4cout << "[DEBUG SteppingAction]" << "→ Particule :" << track->GetParticleDefinition()->GetParticleName()
+                   << ", Énergie input :" << energy/keV << "keV" << G4endl;
+        }
+    }
+
+    // Interaction : dépôt d'énergie ou processus physique réel (ni Transportation, ni msc,
+    // ni monde parallèle / limiteur de biais)
+    const G4double edep = ctx.step->GetTotalEnergyDeposit();
+    const G4VProcess* process = ctx.post->GetProcessDefinedStep();
+    const G4bool physical = process && ProcessRoles::IsPhysical(ctx.procRole);
+
+    if (process && Diag::Verbose(fVerbose)) {
+        G4cout << "\n[DEBUG SteppingAction] 💥 → Processus : " << process->GetProcessName() << G4endl;
+        G4cout << "\n[DEBUG SteppingAction] 💥 → Dépôt d’énergie : " << edep/keV << "keV" << G4endl;
+    }
+
+    if ((edep > 0.0 && edep < DBL_MAX) || physical) {
+        if (Diag::Verbose(fVerbose)) {
+            G4cout << "\n[DEBUG SteppingAction] 💥 Interaction dans le Béryllium !" << G4endl;
+        }
+        if (physical) {
+            if (Diag::Verbose(fVerbose)) {
+                G4cout << " [DEBUG SteppingAction] → Particule : " << track->GetParticleDefinition()->GetParticleName() << G4endl;
+                G4cout << " [DEBUG SteppingAction] → Processus : " << process->GetProcessName() << G4endl;
+                G4cout << " [DEBUG SteppingAction] → Dépôt d’énergie : " << edep/keV << " keV" << G4endl;
+                PrintSecondaries(ctx.step);
+            }
+            fEventAction->IncrementNbInteractedInBe();
+        }
+    }
+
+    // Sortie (logs uniquement)
+    if (preIsBe && !postIsBe && Diag::Verbose(fVerbose)) {
+        G4cout << "[DEBUG SteppingAction] → Particule : " << track->GetParticleDefinition()->GetParticleName()
+               << ", Énergie output :" << track->GetKineticEnergy()/keV << "keV" << G4endl;
+    }
+}
+
+// ============================================================================
+// Couronnes d'eau (logicWaterRing0..4)
+// ============================================================================
+// CORRECTION [30/01/2026] : step->GetTotalEnergyDeposit() est l'énergie déposée
+// PENDANT le step, donc dans le volume PRE-step.
+void WaterRingObserver::OnStep(const StepContext& ctx)
+{
+    if (ctx.preInfo.role != VolumeRole::kWaterRing) return;
+
+    const G4double edepWater = ctx.step->GetTotalEnergyDeposit();
+    if (!(edepWater > 0.0 && edepWater < DBL_MAX)) return;
+
+    const G4int ringIndex = ctx.preInfo.ringIndex;
+    fEventAction->AddEdepToRing(ringIndex, edepWater / keV, ctx.track->GetWeight(),  // en keV, pondéré
+                                ctx.trackInfo->GetPrimarySlot());
+
+    if (Diag::Verbose(fVerbose)) {
+        G4cout << "[DOSE] Edep dans anneau " << ringIndex
+               << " : " << edepWater/keV << " keV" << G4endl;
+    }
+}
+
+// Estimateur de kerma : chaque step de photon dans un anneau contribue
+// w * L * rho * (mu_en/rho)(E) * E, E étant l'énergie du point pre-step
+// (constante le long du step). Tous les photons qui traversent l'anneau
+// scorent, qu'ils y interagissent ou non.
+WaterRingKermaObserver::WaterRingKermaObserver(EventAction* ev)
+: StepObserver("WaterRingKerma"), fEventAction(ev), fGamma(G4Gamma::Definition())
+{}
+
+void WaterRingKermaObserver::OnStep(const StepContext& ctx)
+{
+    if (ctx.preInfo.role != VolumeRole::kWaterRing) return;
+    if (ctx.track->GetParticleDefinition() != fGamma) return;
+
+    const G4double length = ctx.step->GetStepLength();
+    if (length <= 0.) return;
+
+    const G4double ekin = ctx.pre->GetKineticEnergy();
+    const G4double rho  = ctx.pre->GetMaterial()->GetDensity();
+    const G4double kerma = length * rho * WaterMuEn::MassEnergyAbsorption(ekin) * ekin;
+    fEventAction->AddKermaToRing(ctx.preInfo.ringIndex, kerma / keV * ctx.pre->GetWeight(),
+                                 ctx.trackInfo->GetPrimarySlot());
+}
+
+// ============================================================================
+// Compton dans le cône graphite (logicConeCompton)
+// ============================================================================
+// Note Geant4 : lors d'un Compton, le photon diffusé CONTINUE comme le même
+// track (même trackID, parentID == 0) : on le marque donc ici via MyTrackInfo.
+void ComptonConeObserver::OnStep(const StepContext& ctx)
+{
+    if (ctx.preInfo.role != VolumeRole::kConeCompton) return;
+    if (ctx.procRole != ProcessRole::kCompton) return;
+    if (!IsPrimaryPhoton(ctx)) return;
+
+    MyTrackInfo* info = ctx.trackInfo;
+    const G4StepPoint* prePoint  = ctx.pre;
+    const G4StepPoint* postPoint = ctx.post;
+    const G4double weight = ctx.track->GetWeight();
+
+    info->SetComptonInCone(true);
+    info->IncrementNComptonInCone();
+    info->SetLastComptonPos(postPoint->GetPosition());
+    info->SetLastComptonEkin(prePoint->GetKineticEnergy());
+    info->SetLastComptonWeight(weight);
+
+    // Remplissage du ntuple compton_cone_events (une ligne par diffusion)
+    const G4int comptonNtupleId = GetComptonConeNtupleId();
+    if (comptonNtupleId >= 0) {
+        auto* man = G4AnalysisManager::Instance();
+        if (man && man->IsActive()) {
+            // --- Énergies ---
+            const G4double ekin_before = prePoint->GetKineticEnergy() / keV;
+            const G4double ekin_after  = postPoint->GetKineticEnergy() / keV;
+            const G4double delta_ekin  = ekin_before - ekin_after;
+
+            // --- Position de l'interaction ---
+            const G4ThreeVector cpos = postPoint->GetPosition();
+            const G4double cx_mm = cpos.x() / mm;
+            const G4double cy_mm = cpos.y() / mm;
+            const G4double cz_mm = cpos.z() / mm;
+            const G4double cr_mm = std::sqrt(cx_mm*cx_mm + cy_mm*cy_mm);
+
+            // --- Directions incidente / sortante ---
+            const G4ThreeVector dirIn  = prePoint->GetMomentumDirection();
+            const G4ThreeVector dirOut = postPoint->GetMomentumDirection();
+
+            // --- Angle de diffusion Compton : cos(θ) = dirIn · dirOut ---
+            const G4double cos_scatter = dirIn.dot(dirOut);
+            const G4double scatter_angle = std::acos(std::min(1.0, std::max(-1.0, cos_scatter))) / deg;
+
+            man->FillNtupleIColumn(comptonNtupleId,  0, ctx.eventID);                // eventID
+            man->FillNtupleIColumn(comptonNtupleId,  1, ctx.track->GetTrackID());    // trackID
+            man->FillNtupleIColumn(comptonNtupleId,  2, info->GetNComptonInCone());  // n_compton_seq
+            man->FillNtupleDColumn(comptonNtupleId,  3, ekin_before);                // ekin_before_keV
+            man->FillNtupleDColumn(comptonNtupleId,  4, ekin_after);                 // ekin_after_keV
+            man->FillNtupleDColumn(comptonNtupleId,  5, delta_ekin);                 // delta_ekin_keV
+            man->FillNtupleDColumn(comptonNtupleId,  6, cx_mm);                      // x_mm
+            man->FillNtupleDColumn(comptonNtupleId,  7, cy_mm);                      // y_mm
+            man->FillNtupleDColumn(comptonNtupleId,  8, cz_mm);                      // z_mm
+            man->FillNtupleDColumn(comptonNtupleId,  9, cr_mm);                      // r_mm
+            man->FillNtupleDColumn(comptonNtupleId, 10, dirIn.theta() / deg);        // theta_in_deg
+            man->FillNtupleDColumn(comptonNtupleId, 11, dirIn.phi()   / deg);        // phi_in_deg
+            man->FillNtupleDColumn(comptonNtupleId, 12, dirOut.theta() / deg);       // theta_out_deg
+            man->FillNtupleDColumn(comptonNtupleId, 13, dirOut.phi()   / deg);       // phi_out_deg
+            man->FillNtupleDColumn(comptonNtupleId, 14, scatter_angle);              // scatter_angle_deg
+            man->FillNtupleDColumn(comptonNtupleId, 15, cos_scatter);                // cos_scatter
+            man->FillNtupleDColumn(comptonNtupleId, 16, weight);                     // weight
+            man->AddNtupleRow(comptonNtupleId);
+        }
+    }
+
+    // Compteur du bilan (toujours) ; log limité aux 100 premiers puis 1 sur 10000
+    const G4long sComptonConeLog = fLedger->Add(Ledger::kComptonInCone);
+    if (Diag::kEnabled && (sComptonConeLog < 100 || sComptonConeLog % 10000 == 0)) {
+        const G4ThreeVector cpos = postPoint->GetPosition();
+        G4cout << "[STEP][COMPTON_IN_CONE] #" << sComptonConeLog
+               << " | event=" << ctx.eventID
+               << " | trackID=" << ctx.track->GetTrackID()
+               << " | n_compt=" << info->GetNComptonInCone()
+               << " | E_before=" << prePoint->GetKineticEnergy()/keV << " keV"
+               << " | E_after=" << postPoint->GetKineticEnergy()/keV << " keV"
+               << " | pos(mm)=(" << cpos.x()/mm << ", "
+                                  << cpos.y()/mm << ", "
+                                  << cpos.z()/mm << ")"
+               << " | w=" << weight
+               << (info->IsBiasClone() ? " (clone)" : "")
+               << G4endl;
+    }
+}
+
+// ============================================================================
+// Cône graphite : clones du biais forced collision (option -f)
+//
+//  G4BOptrForceCollision clone le photon à l'entrée du cône (step de longueur
+//  nulle, processus biasWrapper(0)) : le clone, forcé à interagir, est un
+//  SECONDAIRE pour Geant4. On lui donne une copie du MyTrackInfo du photon
+//  cloné, marquée IsBiasClone() : le marquage Compton et les ntuples le
+//  traitent comme le primaire, avec son propre poids.
+// ============================================================================
+void BiasCloneObserver::OnStep(const StepContext& ctx)
+{
+    if (ctx.step->GetNumberOfSecondariesInCurrentStep() == 0) return;
+    if (!IsPrimaryPhoton(ctx)) return;
+
+    for (const G4Track* sec : *ctx.step->GetSecondaryInCurrentStep()) {
+        if (sec->GetUserInformation()) continue;
+        // Clone = créé par le processus non physique (sans processus enveloppé)
+        const auto* wrapper = dynamic_cast<const G4BiasingProcessInterface*>(sec->GetCreatorProcess());
+        if (!wrapper || wrapper->GetWrappedProcess() != nullptr) continue;
+
+        auto* info = new MyTrackInfo(*ctx.trackInfo);
+        info->SetBiasClone(true);
+        const_cast<G4Track*>(sec)->SetUserInformation(info);
+    }
+}
+
+// ============================================================================
+// Plan de comptage (logicScorePlane) : primaires uniquement
+// ============================================================================
+void ScorePlaneObserver::OnStep(const StepContext& ctx)
+{
+    if (ctx.track->GetParentID() != 0) return;
+
+    const bool preIsPlane  = (ctx.preInfo.role  == VolumeRole::kScorePlane);
+    const bool postIsPlane = (ctx.postInfo.role == VolumeRole::kScorePlane);
+
+    // [TRACE] Frontières d'entrée/sortie (limité aux 5 premières par thread)
+    {
+        const bool boundary = (ctx.post->GetStepStatus() == fGeomBoundary);
+        const bool enter = !preIsPlane &&  postIsPlane && boundary;
+        const bool leave =  preIsPlane && !postIsPlane && boundary;
+
+        constexpr G4long maxPrint = 5;
+        if ((enter || leave) && Diag::First(fLedger, Ledger::kLogTracePlane, maxPrint)) {
+            G4cout << "[TRACE][PLANE " << (enter ? "ENTER" : "LEAVE") << "] evt=" << CurrentEventID()
+                   << " zPre=" << ctx.pre->GetPosition().z()/mm
+                   << " zPost=" << ctx.post->GetPosition().z()/mm << " mm"
+                   << G4endl;
+        }
+    }
+
+    // Compteurs entrée/sortie : accumulables de RunAction (fusionnés en fin de run)
+    if (!preIsPlane && postIsPlane) {
+        if (fRunAction) fRunAction->AddEnterPlanePrim();
+
+        if (Diag::Verbose(fVerbose) && Diag::First(fLedger, Ledger::kLogStepEnter, 10)) {
+            const auto pos = ctx.post->GetPosition();
+            G4cout << "[STEP][ENTER][prim] -> plane at ("
+                   << pos.x()/mm << "," << pos.y()/mm << "," << pos.z()/mm << ") mm" << G4endl;
+        }
+    }
+
+    if (preIsPlane && !postIsPlane) {
+        if (fRunAction) fRunAction->AddLeavePlanePrim();
+
+        if (Diag::Verbose(fVerbose) && Diag::First(fLedger, Ledger::kLogStepLeave, 10)) {
+            const auto pos = ctx.pre->GetPosition();
+            G4cout << "[STEP][LEAVE][prim] <- plane from ("
+                   << pos.x()/mm << "," << pos.y()/mm << "," << pos.z()/mm << ") mm" << G4endl;
+        }
+    }
+}
+
+// ============================================================================
+// Fin de piste d'un primaire (tout volume)
+// ============================================================================
+void PrimaryEndObserver::OnStep(const StepContext& ctx)
+{
+    const G4Track* track = ctx.track;
+    if (!IsPrimaryPhoton(ctx)) return;   // primaires (et leurs clones -f) uniquement
+
+    const bool died     = (track->GetTrackStatus() == fStopAndKill);
+    const bool outWorld = (ctx.post->GetStepStatus() == fWorldBoundary);
+    if (!(died || outWorld)) return;
+
+    MyTrackInfo* trackInfo = ctx.trackInfo;
+    const G4StepPoint* prePoint  = ctx.pre;
+    const G4StepPoint* postPoint = ctx.post;
+    const G4VProcess* proc = postPoint->GetProcessDefinedStep();
+
+    // Clone forced collision : seules les absorptions sont tallyées (pondérées),
+    // l'état final et les pertes restent ceux du primaire
+    if (!trackInfo->IsBiasClone()) {
+        // [FIX] Transmettre l'état FINAL du trackInfo à EventAction
+        //       (HasEnteredCube() / HasEnteredSphere() en fin de tracking)
+        if (fEventAction) {
+            fEventAction->SetTrackInfo(trackInfo);
+            if (Diag::Verbose(fVerbose)) {
+                G4cout << "[DEBUG SteppingAction] SetTrackInfo (FINAL) - "
+                       << "cube=" << trackInfo->HasEnteredCube()
+                       << " sphere=" << trackInfo->HasEnteredSphere() << G4endl;
+            }
+        }
+
+        // [LOSS] Primaire arrêté avant le plan z=60 mm : comptabiliser (proc + matériau)
+        //        Clés pointeurs : les noms ne sont résolus qu'en fin de run (RunAction)
+        // [FIX] Sauf arrêt au plan de l'espace des phases : pas une perte
+        constexpr G4double zPlane = 60.*mm;
+        if (postPoint->GetPosition().z() < zPlane && fRunAction && !trackInfo->IsStoppedAtPhaseSpace()) {
+            fRunAction->AddLostPrimary(prePoint->GetMaterial(), proc);
+        }
+    }
+
+    // ==================== ABSORPTIONS PHOTOELECTRIQUES ====================
+    // Ntuples abs_graphite (cône graphite) et abs_inox (pièces en SS304)
+    if (ctx.procRole != ProcessRole::kPhotoElectric) return;
+
+    const bool inGraphite = (ctx.preInfo.role == VolumeRole::kConeCompton);
+    const bool inInox     = !inGraphite && ctx.preInfo.isStainless;
+    if (!inGraphite && !inInox) return;
+
+    auto* man = G4AnalysisManager::Instance();
+    if (!man || !man->IsActive()) return;
+
+    const G4int ntupleId = inGraphite ? GetAbsGraphiteNtupleId() : GetAbsInoxNtupleId();
+    if (ntupleId < 0) return;
+
+    const G4ThreeVector absPos = postPoint->GetPosition();
+    const G4double abs_x_mm = absPos.x() / mm;
+    const G4double abs_y_mm = absPos.y() / mm;
+    const G4double abs_z_mm = absPos.z() / mm;
+    const G4double abs_ekin_keV = prePoint->GetKineticEnergy() / keV;
+
+    const G4int had_compton = trackInfo->HasComptonInCone() ? 1 : 0;
+    const G4int n_compton   = trackInfo->GetNComptonInCone();
+
+    man->FillNtupleIColumn(ntupleId, 0, ctx.eventID);           // eventID
+    man->FillNtupleIColumn(ntupleId, 1, track->GetTrackID());   // trackID
+    man->FillNtupleDColumn(ntupleId, 2, abs_ekin_keV);          // ekin_keV
+    man->FillNtupleDColumn(ntupleId, 3, abs_x_mm);              // x_mm
+    man->FillNtupleDColumn(ntupleId, 4, abs_y_mm);              // y_mm
+    man->FillNtupleDColumn(ntupleId, 5, abs_z_mm);              // z_mm
+    if (inGraphite) {
+        man->FillNtupleIColumn(ntupleId, 6, had_compton);       // had_compton_in_cone
+        man->FillNtupleIColumn(ntupleId, 7, n_compton);         // n_compton_in_cone
+        man->FillNtupleDColumn(ntupleId, 8, track->GetWeight()); // weight
+    } else {
+        man->FillNtupleSColumn(ntupleId, 6, LVName(prePoint));  // volume logique
+        man->FillNtupleIColumn(ntupleId, 7, had_compton);       // had_compton_in_cone
+        man->FillNtupleIColumn(ntupleId, 8, n_compton);         // n_compton_in_cone
+        man->FillNtupleDColumn(ntupleId, 9, track->GetWeight()); // weight
+    }
+    man->AddNtupleRow(ntupleId);
+
+    const G4long sAbsLog = fLedger->Add(inGraphite ? Ledger::kAbsGraphite : Ledger::kAbsInox);
+    if (Diag::kEnabled && (sAbsLog < 50 || sAbsLog % 10000 == 0)) {
+        G4cout << (inGraphite ? "[STEP][ABS_GRAPHITE] #" : "[STEP][ABS_INOX] #") << sAbsLog
+               << " | event=" << ctx.eventID
+               << " | E=" << abs_ekin_keV << " keV";
+        if (inInox) G4cout << " | vol=" << LVName(prePoint);
+        G4cout << " | pos(mm)=(" << abs_x_mm << ", "
+                                 << abs_y_mm << ", "
+                                 << abs_z_mm << ")"
+               << " | had_compton=" << had_compton
+               << " | n_compton=" << n_compton
+               << G4endl;
+    }
+}
+
+// ============================================================================
+// Maillage 3D de dose (DoseMesh) : tous volumes, seule la boîte compte
+// ============================================================================
+DoseMeshObserver::DoseMeshObserver(RunAction* run)
+: StepObserver("DoseMesh"), fMesh(&run->GetDoseMesh())
+{}
+
+void DoseMeshObserver::OnStep(const StepContext& ctx)
+{
+    if (!DoseMesh::IsEnabled()) return;
+
+    const G4double edep = ctx.step->GetTotalEnergyDeposit();
+    if (!(edep > 0.)) return;
+
+    // Perte continue des chargées répartie le long du step : point tiré uniformément ;
+    // photons : dépôt local (énergie de liaison, sous le seuil) au point d'interaction
+    G4ThreeVector pos = ctx.post->GetPosition();
+    if (ctx.track->GetDefinition()->GetPDGCharge() != 0.) {
+        const G4ThreeVector& start = ctx.pre->GetPosition();
+        pos = start + G4UniformRand() * (pos - start);
+    }
+    fMesh->Deposit(pos, edep / keV * ctx.track->GetWeight(), ctx.trackInfo->GetPrimarySlot());
+}
+
+// ============================================================================
+// Arrêt géométrique (TrackKiller) : évalué aux frontières seulement
+// ============================================================================
+TrackKillObserver::TrackKillObserver(RunAction* run, RunLedger* ledger)
+: StepObserver("TrackKill"), fRunAction(run), fLedger(ledger),
+  fGamma(G4Gamma::Definition()), fElectron(G4Electron::Definition()), fPositron(G4Positron::Definition())
+{}
+
+void TrackKillObserver::OnStep(const StepContext& ctx)
+{
+    if (!TrackKiller::IsEnabled()) return;
+    if (ctx.post->GetStepStatus() != fGeomBoundary) return;
+
+    G4Track* track = ctx.track;
+    if (track->GetTrackStatus() != fAlive) return;
+
+    const G4ParticleDefinition* part = track->GetParticleDefinition();
+    if (part != fGamma && part != fElectron && part != fPositron) return;
+
+    const G4int rule = TrackKiller::Evaluate(ctx.post->GetPosition(), ctx.post->GetMomentumDirection());
+    if (rule == TrackKiller::kNone) return;
+
+    track->SetTrackStatus(fStopAndKill);
+
+    fLedger->Add(rule == TrackKiller::kBackward ? Ledger::kKillBackward
+               : rule == TrackKiller::kSide     ? Ledger::kKillSide
+                                                : Ledger::kKillBeyond);
+    if (fRunAction) {
+        const auto* pv = ctx.pre->GetPhysicalVolume();
+        fRunAction->AddKilledTrack(pv ? pv->GetLogicalVolume() : nullptr,
+                                   ctx.post->GetKineticEnergy() / keV * track->GetWeight());
+    }
+}
+
+// ============================================================================
+// Espace des phases (plan z = /phasespace/planeZ)
+// ============================================================================
+void PhaseSpaceObserver::OnStep(const StepContext& ctx)
+{
+    const G4bool writing = PhaseSpace::IsWriting();
+    const G4bool replaying = PhaseSpace::IsReplaying();
+    if (!writing && !replaying) return;
+
+    const G4double zPlane = PhaseSpace::GetPlaneZ();
+    const G4ThreeVector& p0 = ctx.pre->GetPosition();
+    const G4ThreeVector& p1 = ctx.post->GetPosition();
+
+    // ----- Rejeu : l'amont du plan est déjà dans le fichier -----
+    if (replaying) {
+        if (p0.z() >= zPlane && p1.z() < zPlane) {
+            ctx.track->SetTrackStatus(fStopAndKill);
+            ctx.trackInfo->SetStoppedAtPhaseSpace(true);
+            fLedger->Add(Ledger::kPhaseSpaceUpstream);
+        }
+        return;
+    }
+
+    // ----- Écriture : traversée du plan vers +z pendant ce step -----
+    if (!(p0.z() < zPlane && p1.z() >= zPlane)) return;
+
+    G4bool known = false;
+    const auto type = PhaseSpace::TypeOf(ctx.track->GetParticleDefinition()->GetParticleName(), known);
+    if (known) {
+        // Point de traversée interpolé sur la corde du step (exact pour les photons),
+        // direction et énergie du point pre-step
+        const G4double f = (zPlane - p0.z()) / (p1.z() - p0.z());
+        PhaseSpace::Record rec;
+        rec.type      = type;
+        rec.position  = p0 + f * (p1 - p0);
+        rec.direction = ctx.pre->GetMomentumDirection();
+        rec.ekin      = ctx.pre->GetKineticEnergy();
+        rec.weight    = ctx.pre->GetWeight();
+        PhaseSpace::Write(ctx.eventID, ctx.trackInfo->GetPrimarySlot(), rec);
+        fLedger->Add(Ledger::kPhaseSpaceWritten);
+    } else {
+        // [FIX] Type hors format (ni gamma, ni e-, ni e+) : arrêté aussi, mais compté
+        fLedger->Add(Ledger::kPhaseSpaceDropped);
+    }
+
+    // Arrêt au plan, avec les secondaires créés en aval pendant ce step :
+    // l'interaction sera rejouée à l'étape 2
+    ctx.track->SetTrackStatus(fStopAndKill);
+    ctx.trackInfo->SetStoppedAtPhaseSpace(true);
+    if (const auto* secondaries = ctx.step->GetSecondaryInCurrentStep()) {
+        for (const G4Track* sec : *secondaries) {
+            const_cast<G4Track*>(sec)->SetTrackStatus(fStopAndKill);
+        }
+    }
+}
+
+// ============================================================================
+// Rejet par la portée (RangeRejection) : électrons confinés dans leur volume
+// ============================================================================
+RangeRejectionObserver::RangeRejectionObserver(RunAction* run, RunLedger* ledger)
+: StepObserver("RangeRejection"), fRunAction(run), fLedger(ledger),
+  fElectron(G4Electron::Definition())
+{}
+
+RangeRejectionObserver::~RangeRejectionObserver() = default;
+
+// Frontière interne : de l'autre côté de la face la plus proche du volume
+// courant, un autre volume d'un matériau sélectionné dont la safety autour du
+// point sonde couvre le reste du parcours (range - safety). Approximation :
+// seule la face la plus proche est sondée (coins non vérifiés).
+G4bool RangeRejectionObserver::NeighbourContains(const G4StepPoint* post, G4double safety, G4double range)
+{
+    // Au-delà de la tolérance de surface, en deçà des portées (µm)
+    constexpr G4double kProbeStep = 10.*nanometer;
+
+    const G4VTouchable* touch = post->GetTouchable();
+    G4VSolid* solid = touch ? touch->GetSolid() : nullptr;
+    const G4NavigationHistory* history = touch ? touch->GetHistory() : nullptr;
+    if (!solid || !history) return false;
+
+    // Face du volume courant ; si une fille est plus proche, pas de sonde
+    const G4AffineTransform& toLocal = history->GetTopTransform();
+    const G4ThreeVector local = toLocal.TransformPoint(post->GetPosition());
+    if (solid->DistanceToOut(local) > safety + kProbeStep) return false;
+    const G4ThreeVector normal = toLocal.InverseTransformAxis(solid->SurfaceNormal(local));
+    if (normal.mag2() <= 0.) return false;
+
+    if (!fProbe) {
+        fProbe = std::make_unique<G4Navigator>();
+        fProbe->SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                                   ->GetNavigatorForTracking()->GetWorldVolume());
+    }
+    const G4ThreeVector probe = post->GetPosition() + (safety + kProbeStep) * normal.unit();
+    const G4VPhysicalVolume* pv = fProbe->LocateGlobalPointAndSetup(probe, nullptr, false, true);
+    if (!pv || pv == post->GetPhysicalVolume()) return false;
+    if (!RangeRejection::Applies(pv->GetLogicalVolume()->GetMaterial())) return false;
+
+    return range - safety < fProbe->ComputeSafety(probe);
+}
+
+void RangeRejectionObserver::OnStep(const StepContext& ctx)
+{
+    if (!RangeRejection::IsEnabled()) return;
+
+    G4Track* track = ctx.track;
+    if (track->GetParticleDefinition() != fElectron) return;
+    if (track->GetTrackStatus() != fAlive) return;
+
+    // [FIX] Photo- et Compton-électrons seulement : les électrons du faisceau
+    //       (source 3) et leurs deltas rayonnent dans l'anode (brem, fluorescence W)
+    switch (ProcessRoles::Of(ctx.trackInfo->GetCreatorProcessPtr())) {
+        case ProcessRole::kPhotoElectric:
+        case ProcessRole::kCompton:
+            break;
+        default:
+            return;
+    }
+
+    // Jamais dans un scoreur : le dépôt des couronnes reste celui du transport
+    switch (ctx.postInfo.role) {
+        case VolumeRole::kWaterRing:
+        case VolumeRole::kScorePlane:
+        case VolumeRole::kWaterCube:
+        case VolumeRole::kSphereWater:
+            return;
+        default:
+            break;
+    }
+
+    const G4double ekin = ctx.post->GetKineticEnergy();
+    if (ekin > RangeRejection::GetMaxEnergy()) return;
+
+    const G4Material* mat = ctx.post->GetMaterial();
+    if (!RangeRejection::Applies(mat)) return;
+
+    const G4double range = G4LossTableManager::Instance()->GetRange(
+        fElectron, ekin, ctx.post->GetMaterialCutsCouple());
+    const G4ThreeVector& pos = ctx.post->GetPosition();
+
+    // [FIX] 1. Reste dans le volume : la safety du point post-step est déjà
+    //          isotrope autour de ce point (le transport en a retiré la
+    //          longueur du step), borne inférieure gratuite
+    G4double safety = ctx.post->GetSafety();
+    if (range >= safety) {
+        // [FIX] 2. Peut quitter le volume : hors de portée de tout scoreur, et
+        //          frontière interne vers un autre matériau sélectionné
+        if (range >= RangeRejection::DistanceToScorers(pos)) return;
+        static G4ThreadLocal G4SafetyHelper* safetyHelper = nullptr;
+        if (!safetyHelper) safetyHelper = G4TransportationManager::GetTransportationManager()->GetSafetyHelper();
+        safety = safetyHelper->ComputeSafety(pos);
+        if (range >= safety && !NeighbourContains(ctx.post, safety, range)) return;
+    }
+
+    // [FIX] Dépôt local : tally par matériau et, comme un dépôt de step, maillage
+    //       de dose au point d'arrêt (jamais une couronne : scoreurs exclus)
+    const G4double edep = ekin / keV * track->GetWeight();
+    track->SetTrackStatus(fStopAndKill);
+    fLedger->Add(Ledger::kRangeRejected);
+    if (fRunAction) {
+        fRunAction->AddRangeRejected(mat, edep);
+        if (DoseMesh::IsEnabled()) fRunAction->GetDoseMesh().Deposit(pos, edep, ctx.trackInfo->GetPrimarySlot());
+    }
+}
+
+// ============================================================================
+// Cube d'eau (logicWaterCube)
+// ============================================================================
+void WaterCubeObserver::OnStep(const StepContext& ctx)
+{
+    // Entrée : marquée une seule fois par track
+    if (!ctx.trackInfo->HasEnteredCube() && ctx.postInfo.role == VolumeRole::kWaterCube) {
+        ctx.trackInfo->SetEnteredCube(true);
+    }
+
+    // Sortie définitive du cube (ni vers le cube, ni vers la sphère) : arrêt du track
+    if (ctx.preInfo.role  == VolumeRole::kWaterCube &&
+        ctx.postInfo.role != VolumeRole::kWaterCube &&
+        ctx.postInfo.role != VolumeRole::kSphereWater) {
+        if (Diag::Verbose(fVerbose)) {
+            G4cout << "[DEBUG SteppingAction] ☠️ Particule tuée (sortie définitive de logicWaterCube)" << G4endl;
+            G4cout << "[DEBUG SteppingAction] de " << LVName(ctx.pre) << " → " << LVName(ctx.post) << G4endl;
+        }
+        ctx.track->SetTrackStatus(fStopAndKill);
+    }
+}
+
+// ============================================================================
+// Sphère d'eau (logicsphereWater)
+// ============================================================================
+void WaterSphereObserver::OnStep(const StepContext& ctx)
+{
+    // Entrée : marquée une seule fois par track
+    if (!ctx.trackInfo->HasEnteredSphere() && ctx.postInfo.role == VolumeRole::kSphereWater) {
+        ctx.trackInfo->SetEnteredSphere(true);
+        fEventAction->IncrementNbEntrantInWaterSphere();
+        if (Diag::Verbose(fVerbose)) {
+            G4cout << "NbEntrantInWaterSphere : " << fEventAction->GetNbEntrantInWaterSphere() << G4endl;
+        }
+    }
+
+    // Interaction : step entièrement dans la sphère, processus physique réel
+    if (ctx.preInfo.role != VolumeRole::kSphereWater || ctx.postInfo.role != VolumeRole::kSphereWater) return;
+
+    const G4VProcess* process = ctx.post->GetProcessDefinedStep();
+    if (!process || !ProcessRoles::IsPhysical(ctx.procRole)) return;
+
+    if (Diag::Verbose(fVerbose)) {
+        G4cout << "\n[DEBUG SteppingAction] 💦 Interaction dans WaterSphere !" << G4endl;
+        G4cout << " [DEBUG SteppingAction] → Particule : " << ctx.track->GetParticleDefinition()->GetParticleName() << G4endl;
+        G4cout << " [DEBUG SteppingAction] → Processus : " << process->GetProcessName() << G4endl;
+        G4cout << " [DEBUG SteppingAction] → Dépôt d’énergie :" << ctx.step->GetTotalEnergyDeposit()/keV << " keV" << G4endl;
+        PrintSecondaries(ctx.step);
+    }
+
+    fEventAction->IncrementNbInteractedInWaterSphere();
+    if (Diag::Verbose(fVerbose)) {
+        G4cout << "[DEBUG SteppingAction] NbInteractedtInWaterSphere : "
+               << fEventAction->GetNbInteractedInWaterSphere() << G4endl;
+    }
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+void EnveloppeExitObserver::OnStep(const StepContext& ctx)
+{
+    if (ctx.preInfo.role != VolumeRole::kEnveloppe || ctx.postInfo.role == VolumeRole::kEnveloppe) return;
+
+    const G4ThreeVector sortie = ctx.post->GetPosition();
+    const G4String& particleName = ctx.track->GetParticleDefinition()->GetParticleName();
+    const G4bool isPrimary = (ctx.track->GetParentID() == 0);
+
+    G4cout << "\n[DEBUG SteppingAction] 🚪 Sortie de la sphère EnveloppeGDML détectée !" << G4endl;
+    G4cout << "  → Position sortie : " << sortie / mm << " mm" << G4endl;
+    G4cout << "  → Particule       : " << particleName << G4endl;
+    G4cout << "  → Énergie         : " << ctx.track->GetKineticEnergy() / keV << " keV" << G4endl;
+    G4cout << "\n[DEBUG SteppingAction] " << (isPrimary ? "✅ Sortie d'une particule primaire ("
+                                                        : "🌀 Sortie d'une particule secondaire (")
+           << particleName << ") de l'enveloppe GDML" << G4endl;
+    G4cout << "r → " << sortie.mag() << "theta → " << sortie.theta()/deg << "phi → " << sortie.phi()/deg << G4endl;
+}
+
+void Z60TraceObserver::OnStep(const StepContext& ctx)
+{
+    if (ctx.track->GetParentID() != 0) return;   // primaire uniquement
+
+    // Pour un faisceau +Z : croisement si z_pre <= 60 et z_post >= 60
+    constexpr G4double zPlane = 60.0*mm;
+    const G4double zPre  = ctx.pre->GetPosition().z();
+    const G4double zPost = ctx.post->GetPosition().z();
+    if (!(zPre <= zPlane && zPost >= zPlane)) return;
+
+    constexpr G4long maxPrint = 5;
+    if (Diag::First(fLedger, Ledger::kLogTraceZ60, maxPrint)) {
+        G4cout << "[TRACE][Z=60] evt=" << CurrentEventID()
+               << " preZ=" << zPre/mm << " postZ=" << zPost/mm << " mm"
+               << G4endl;
+    }
+}
+
+void VerboseStepObserver::OnStep(const StepContext& ctx)
+{
+    const G4Track* track = ctx.track;
+    const G4int eventID = ctx.eventID;
+    const G4ThreeVector prePos  = ctx.pre->GetPosition();
+    const G4ThreeVector postPos = ctx.post->GetPosition();
+    const G4String& namePre  = LVName(ctx.pre);
+    const G4String& namePost = LVName(ctx.post);
+
+    if (Diag::Verbose(fVerbose)) {
+        G4cout << " \n[DEBUG SteppingAction] Event]  " << eventID << G4endl;
+        G4cout << " \n[DEBUG SteppingAction] Step : " << track->GetCurrentStepNumber() << G4endl;
+        G4cout << " \n[DEBUG SteppingAction] PreStep position : " << prePos / mm << " mm" << G4endl;
+        G4cout << " \n[DEBUG SteppingAction] PostStep position: " << postPos / mm << " mm" << G4endl;
+        G4cout << " \n[DEBUG SteppingAction] PreStep volume   : " << namePre << ", matériau : " << MatName(ctx.pre) << G4endl;
+        G4cout << " \n[DEBUG SteppingAction] PostStep volume  : " << namePost << ", matériau : " << MatName(ctx.post) << G4endl;
+        if (track->GetCurrentStepNumber() == 1) {
+            G4cout << " \n[DEBUG SteppingAction] Step 1 Event " << eventID << " \n namePre =" << namePre << " \n namePost =" << namePost << G4endl;
+            G4cout << " \n[DEBUG SteppingAction] Step 1 Event " << eventID << " \n prePos=" << prePos/mm << " \n postPos=" << postPos/mm << G4endl;
+            G4cout << " \n[DEBUG SteppingAction] Step 1 Event " << eventID << " \n Vertex=" << track->GetVertexPosition()/mm << G4endl;
+        }
+
+        G4cout << "[DEBUG SteppingAction]  Event #" << eventID << " — trackID: " << track->GetTrackID() << G4endl;
+        G4cout << "[DEBUG SteppingAction] → de " << namePre << " → " << namePost << G4endl;
+        if (ctx.trackInfo->HasEnteredCube())
+            G4cout << "[DEBUG SteppingAction] ✓ Entré dans cube\n";
+        if (ctx.trackInfo->HasEnteredSphere())
+            G4cout << "[DEBUG SteppingAction] ✓ Entré dans sphère\n";
+        G4cout << "[DEBUG SteppingAction] → Processus créateur : " << ctx.trackInfo->GetCreatorProcess() << G4endl;
+    }
+
+    if (Diag::Verbose(fVerbose, 2)) {
+        G4cout << "[DEBUG SteppingAction] [Thread " << G4Threading::G4GetThreadId() << "] Event #" << eventID
+               << " → de " << namePre << " → " << namePost << ", TrackID = " << track->GetTrackID() << G4endl;
+        G4cout << "[DEBUG SteppingAction] Event #" << eventID << "[Trace] de " << namePre << " (" << MatName(ctx.pre) << ")"
+               << " → " << namePost << " (" << MatName(ctx.post) << ")" << G4endl;
+        G4cout << "[DEBUG SteppingAction] Event #" << eventID << " → Position input : " << prePos/mm << " mm"
+               << " → Position output : " << postPos/mm << " mm" << G4endl;
+    }
+}
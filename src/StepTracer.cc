@@ -0,0 +1,180 @@
+#include "StepTracer.hh"
+#include "StepTracerMessenger.hh"
+#include "Diagnostics.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <iomanip>
+#include <sstream>
+
+// ==================== Configuration partagée ====================
+G4int                   StepTracer::fMaxEvents = 10;
+G4int                   StepTracer::fEvery     = 1;
+G4double                StepTracer::fEMin      = 0.;
+G4double                StepTracer::fEMax      = DBL_MAX;
+StepTracer::EventFilter StepTracer::fFilter;
+std::atomic<G4int>      StepTracer::fTracedCount{0};
+StepTracerMessenger*    StepTracer::fMessenger = nullptr;
+
+StepTracer* StepTracer::Instance()
+{
+    static G4ThreadLocal StepTracer* instance = nullptr;
+    if (!instance) {
+        instance = new StepTracer();
+        // Configuration commune à tous les threads : un seul messenger (master / SEQ)
+        if (G4Threading::IsMasterThread() && !fMessenger) fMessenger = new StepTracerMessenger();
+    }
+    return instance;
+}
+
+G4int StepTracer::GetTracedCount()
+{
+    // Le compteur peut dépasser le max (réservations refusées) : on le borne
+    return std::min(fTracedCount.load(), fMaxEvents);
+}
+
+void StepTracer::BeginRun()
+{
+    // État propre au thread appelant (chaque RunAction de worker l'appelle)
+    StepTracer* tracer = Instance();
+    tracer->fActive    = false;
+    tracer->fExhausted = !Diag::kEnabled || fMaxEvents <= 0;
+
+    // Budget global + en-tête : une seule fois par run (master en MT, ou SEQ).
+    // Le BeginOfRunAction du master précède ceux des workers.
+    if (!G4Threading::IsMasterThread()) return;
+    fTracedCount = 0;
+    if (tracer->fExhausted) return;
+
+    G4cout << "\n"
+           << "========================================================================================================\n"
+           << "                         SUIVI STEP PAR STEP DE " << fMaxEvents << " EVENEMENTS"
+           << " (1 sur " << fEvery << ")";
+    if (fEMin > 0. || fEMax < DBL_MAX) {
+        G4cout << " E_prim dans [" << fEMin/keV << ", " << (fEMax < DBL_MAX ? fEMax/keV : DBL_MAX) << "] keV";
+    }
+    if (fFilter) G4cout << " + filtre";
+    G4cout << "\n"
+           << "========================================================================================================\n"
+           << std::setw(4)  << "Evt"
+           << std::setw(5)  << "Trk"
+           << std::setw(4)  << "Stp"
+           << std::setw(8)  << "Part"
+           << std::setw(4)  << "Sec"
+           << std::setw(10) << "Ekin(keV)"
+           << "  " << std::left << std::setw(22) << "PreVolume" << std::right
+           << std::setw(26) << "PrePos(mm)"
+           << "  " << std::left << std::setw(22) << "PostVolume" << std::right
+           << std::setw(26) << "PostPos(mm)"
+           << G4endl;
+    G4cout << std::string(138, '-') << G4endl;
+}
+
+G4bool StepTracer::Accepts(const G4Event* event) const
+{
+    if (!event) return false;
+    if (event->GetEventID() % fEvery != 0) return false;
+
+    if (fEMin > 0. || fEMax < DBL_MAX) {
+        const G4PrimaryVertex* vtx = event->GetPrimaryVertex();
+        const G4PrimaryParticle* prim = vtx ? vtx->GetPrimary() : nullptr;
+        if (!prim) return false;
+        const G4double ekin = prim->GetKineticEnergy();
+        if (ekin < fEMin || ekin > fEMax) return false;
+    }
+
+    return !fFilter || fFilter(event);
+}
+
+void StepTracer::BeginEvent(const G4Event* event)
+{
+    fActive = false;
+    if (fExhausted) return;   // budget épuisé : plus rien à faire jusqu'au run suivant
+
+    if (fTracedCount.load(std::memory_order_relaxed) >= fMaxEvents) {
+        fExhausted = true;
+        return;
+    }
+    if (!Accepts(event)) return;
+
+    // Réserver une place dans le budget global (atomique, sans verrou)
+    const G4int slot = fTracedCount.fetch_add(1);
+    if (slot >= fMaxEvents) {
+        fExhausted = true;
+        return;
+    }
+    fActive = true;
+
+    G4cout << "\n>>> Evenement #" << event->GetEventID()
+           << " (total suivi: " << (slot + 1) << "/" << fMaxEvents << ") <<<\n" << G4endl;
+}
+
+// ==================== Ligne du tableau (track suivie) ====================
+void StepTracer::PrintStep(const G4Step* step, G4int eventID) const
+{
+    const G4Track* track = step->GetTrack();
+    const G4StepPoint* prePoint = step->GetPreStepPoint();
+    const G4StepPoint* postPoint = step->GetPostStepPoint();
+    
+    if (!track || !prePoint || !postPoint) return;
+    
+    G4int trackID = track->GetTrackID();
+    G4int parentID = track->GetParentID();
+    G4int stepNumber = track->GetCurrentStepNumber();
+    G4String particleName = track->GetDefinition()->GetParticleName();
+    G4int isSecondary = (parentID == 0) ? 0 : 1;
+    G4double ekin = prePoint->GetKineticEnergy() / CLHEP::keV;
+    
+    G4String preVolumeName = "OutOfWorld";
+    G4String postVolumeName = "OutOfWorld";
+    
+    if (prePoint->GetTouchableHandle()->GetVolume()) {
+        preVolumeName = prePoint->GetTouchableHandle()->GetVolume()->GetName();
+    }
+    if (postPoint->GetTouchableHandle()->GetVolume()) {
+        postVolumeName = postPoint->GetTouchableHandle()->GetVolume()->GetName();
+    }
+    
+    // Tronquer les noms de volumes longs (max 20 caractères)
+    const size_t maxVolNameLen = 20;
+    if (preVolumeName.length() > maxVolNameLen) {
+        preVolumeName = preVolumeName.substr(0, maxVolNameLen-2) + "..";
+    }
+    if (postVolumeName.length() > maxVolNameLen) {
+        postVolumeName = postVolumeName.substr(0, maxVolNameLen-2) + "..";
+    }
+    
+    // Tronquer le nom de particule si nécessaire
+    if (particleName.length() > 6) {
+        particleName = particleName.substr(0, 6);
+    }
+    
+    G4ThreeVector prePos = prePoint->GetPosition();
+    G4ThreeVector postPos = postPoint->GetPosition();
+    
+    std::ostringstream prePosStr, postPosStr;
+    prePosStr << std::fixed << std::setprecision(2) 
+              << "(" << prePos.x()/mm << "," << prePos.y()/mm << "," << prePos.z()/mm << ")";
+    postPosStr << std::fixed << std::setprecision(2) 
+               << "(" << postPos.x()/mm << "," << postPos.y()/mm << "," << postPos.z()/mm << ")";
+    
+    G4cout << std::setw(4)  << eventID
+           << std::setw(5)  << trackID
+           << std::setw(4)  << stepNumber
+           << std::setw(8)  << particleName
+           << std::setw(4)  << isSecondary
+           << std::setw(10) << std::fixed << std::setprecision(3) << ekin
+           << "  " << std::left << std::setw(20) << preVolumeName << std::right
+           << std::setw(26) << prePosStr.str()
+           << "  " << std::left << std::setw(20) << postVolumeName << std::right
+           << std::setw(26) << postPosStr.str()
+           << G4endl;
+}
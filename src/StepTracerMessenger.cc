@@ -0,0 +1,65 @@
+#include "StepTracerMessenger.hh"
+#include "StepTracer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : la configuration du
+//  StepTracer est partagée par tous les threads, les commandes ne sont donc
+//  pas retransmises aux workers.
+StepTracerMessenger::StepTracerMessenger()
+{
+    fDir = new G4UIdirectory("/tracer/");
+    fDir->SetGuidance("Suivi step par step d'un échantillon d'événements.");
+
+    fMaxEventsCmd = new G4UIcmdWithAnInteger("/tracer/maxEvents", this);
+    fMaxEventsCmd->SetGuidance("Nombre d'événements suivis sur le run (0 = aucun).");
+    fMaxEventsCmd->SetParameterName("n", false);
+    fMaxEventsCmd->SetRange("n>=0");
+    fMaxEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fMaxEventsCmd->SetToBeBroadcasted(false);
+
+    fEveryCmd = new G4UIcmdWithAnInteger("/tracer/every", this);
+    fEveryCmd->SetGuidance("Ne considérer qu'un événement sur N (eventID % N == 0).");
+    fEveryCmd->SetParameterName("n", false);
+    fEveryCmd->SetRange("n>=1");
+    fEveryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEveryCmd->SetToBeBroadcasted(false);
+
+    fEMinCmd = new G4UIcmdWithADoubleAndUnit("/tracer/eMin", this);
+    fEMinCmd->SetGuidance("Énergie cinétique minimale du primaire des événements suivis.");
+    fEMinCmd->SetParameterName("eMin", false);
+    fEMinCmd->SetDefaultUnit("keV");
+    fEMinCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEMinCmd->SetToBeBroadcasted(false);
+
+    fEMaxCmd = new G4UIcmdWithADoubleAndUnit("/tracer/eMax", this);
+    fEMaxCmd->SetGuidance("Énergie cinétique maximale du primaire des événements suivis.");
+    fEMaxCmd->SetParameterName("eMax", false);
+    fEMaxCmd->SetDefaultUnit("keV");
+    fEMaxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEMaxCmd->SetToBeBroadcasted(false);
+}
+
+StepTracerMessenger::~StepTracerMessenger()
+{
+    delete fMaxEventsCmd;
+    delete fEveryCmd;
+    delete fEMinCmd;
+    delete fEMaxCmd;
+    delete fDir;
+}
+
+void StepTracerMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fMaxEventsCmd) {
+        StepTracer::SetMaxEvents(fMaxEventsCmd->GetNewIntValue(value));
+    } else if (command == fEveryCmd) {
+        StepTracer::SetEvery(fEveryCmd->GetNewIntValue(value));
+    } else if (command == fEMinCmd) {
+        StepTracer::SetEMin(fEMinCmd->GetNewDoubleValue(value));
+    } else if (command == fEMaxCmd) {
+        StepTracer::SetEMax(fEMaxCmd->GetNewDoubleValue(value));
+    }
+}
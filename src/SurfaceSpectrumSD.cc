@@ -10,6 +10,9 @@
 #include "G4VProcess.hh"
 #include "G4LogicalVolume.hh"
 #include "MyTrackInfo.hh"
+#include "RunLedger.hh"
+#include "Diagnostics.hh"
+#include "PlaneTallies.hh"
 
 // ============================================================================
 // [ADD] Helper Master/Worker (ou SEQ) pour les logs
@@ -32,10 +35,7 @@ SurfaceSpectrumSD::SurfaceSpectrumSD(const G4String& name,
 ,fNBins(nBins)
 ,fOutwardOnly(outwardOnly)
 ,fPassageNtupleId(-1)
-,fCntEnter(0)
-,fCntLeave(0)
-,fCntOut(0)
-,fCntRows(0)
+,fLedger(RunLedger::Instance())
 {
 
   // [ADD] largeur de bin et histogramme
@@ -97,12 +97,11 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   const bool enteringPlane =
   ( (!prePV) || (prePV->GetName() != "physScorePlane") ) &&
   ( postPV && postPV->GetName() == "physScorePlane" );
-  if (enteringPlane) { ++fCntEnter; }
+  if (enteringPlane) { fLedger->Add(Ledger::kSpecEnter); }
 
   // [ADD] Trace léger : appels à ProcessHits (limité à 30 lignes)
   {
-    static int dbg_calls = 0;
-    if (dbg_calls < 30) {
+    if (Diag::First(fLedger, Ledger::kSpecLogCalls, 30)) {
       G4cout << "[SpecSD::ProcessHits] pre=" << (prePV ? prePV->GetName() : "<null>")
       << " -> post=" << (postPV ? postPV->GetName() : "<null>")
       << " prePos=" << posPre/mm << " mm"
@@ -111,7 +110,6 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
       << " onlyOutward=" << (fOutwardOnly ? "true" : "false")
       << " ntupleId=" << fPassageNtupleId
       << G4endl;
-      ++dbg_calls;
     }
   }
 
@@ -122,20 +120,19 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   (prePV && prePV->GetName() == "physScorePlane") &&
   (!postPV || postPV->GetName() != "physScorePlane");
   if (!leavingPlane) {
-    static int dbg_reject_leave = 0;
-    if (dbg_reject_leave < 10) {
+    if (Diag::First(fLedger, Ledger::kSpecLogRejectLeave, 10)) {
       G4cout << "[SpecSD] skip (not leaving physScorePlane)"
       << " pre="  << (prePV  ? prePV->GetName()  : "<null>")
       << " post=" << (postPV ? postPV->GetName() : "<null>")
       << G4endl;
-      ++dbg_reject_leave;
     }
     return false;
   }
+  fLedger->Add(Ledger::kSpecLeave);
 
   // [ADD] outward subset counter (only when outward-only filter is active and passed)
   if (fOutwardOnly && dir.z() > 0.) { 
-    ++fCntOut;
+    fLedger->Add(Ledger::kSpecOut);
     
     // [ADD] Incrémenter le compteur de photons transmis dans RunAction
     auto* runManager = G4RunManager::GetRunManager();
@@ -143,17 +140,17 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
       auto* runAction = const_cast<RunAction*>(
         static_cast<const RunAction*>(runManager->GetUserRunAction()));
       if (runAction) {
-        runAction->AddTransmittedPhoton();
+        // score rangé avec le primaire d'origine (événements multi-photons)
+        const auto* info = static_cast<const MyTrackInfo*>(step->GetTrack()->GetUserInformation());
+        runAction->AddTransmittedPhoton(step->GetTrack()->GetWeight(), info ? info->GetPrimarySlot() : 0);
       }
     }
   }
 
   // [FIX] Direction monde : garder uniquement le flux sortant vers +Z si demandé
   if (fOutwardOnly && dir.z() <= 0.) {
-    static int dbg_reject_inward = 0;
-    if (dbg_reject_inward < 10) {
+    if (Diag::First(fLedger, Ledger::kSpecLogRejectInward, 10)) {
       G4cout << "[SpecSD] REJECT (inward/side) dirZ=" << dir.z() << G4endl;
-      ++dbg_reject_inward;
     }
     return false;
   }
@@ -161,12 +158,23 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   // [KEEP] Énergie au point de sortie (post-step), en keV
   const G4double E_keV = post->GetKineticEnergy()/keV;
 
-  // [KEEP] Binning du spectre
+  // [FIX] Poids statistique de la track (1 en analogue : spectre inchangé)
+  const G4double weight = step->GetTrack()->GetWeight();
+
+  // [KEEP] Binning du spectre (somme des poids par bin)
   const G4int ib = BinIndex(E_keV, fEMin_keV, fEMax_keV, fNBins);
-  if (ib >= 0) fBins[ib] += 1.0;
+  if (ib >= 0) fBins[ib] += weight;
+
+  // [ADD] Tallies binnés (/tallies/mode tallies|both), position au point de sortie
+  if (PlaneTallies::FillTallies()) {
+    const auto pos = post->GetPosition();
+    PlaneTallies::Fill(PlaneTallies::kScorePlane, step->GetTrack(), pos.x()/mm, pos.y()/mm, E_keV);
+  }
 
-  // [FIX] Écriture dans l'ntuple de passages (si actif)
-  if (fPassageNtupleId >= 0) {
+  // [FIX] Écriture dans l'ntuple de passages (si actif, /tallies/mode ntuple|both)
+  //       En mode tallies seul, les compteurs rows / compton_redirected / secondaries
+  //       du bilan restent à 0 : la répartition est dans les histogrammes SP1_E_*
+  if (fPassageNtupleId >= 0 && PlaneTallies::WriteRows()) {
     auto* man = G4AnalysisManager::Instance();
     if (man && man->IsActive()) {
       // [FIX] Position au point de sortie (post-step)
@@ -194,7 +202,8 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
       // colonnes : pdg, name, is_secondary, x_mm, y_mm, z_mm, ekin_keV, trackID, parentID, creator_process
       
       // Calculer is_secondary (0 = primaire, 1 = secondaire)
-      G4int is_secondary = (parentID == 0) ? 0 : 1;
+      // (clone forced collision d'un primaire = primaire, cf. MyTrackInfo::IsPrimary)
+      G4int is_secondary = MyTrackInfo::IsPrimary(track) ? 0 : 1;
 
       // ================================================================
       // [ADD] Lecture du flag Compton dans le cône (via MyTrackInfo)
@@ -217,9 +226,9 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
       // ================================================================
       // [ADD] Log des primaires redirigés par Compton dans le cône
       // ================================================================
-      if (parentID == 0 && compton_in_cone) {
-          static G4int sComptonPlaneLog = 0;
-          if (sComptonPlaneLog < 200 || sComptonPlaneLog % 5000 == 0) {
+      if (!is_secondary && compton_in_cone) {
+          const G4long sComptonPlaneLog = fLedger->Add(Ledger::kSpecComptonRedirected);
+          if (Diag::kEnabled && (sComptonPlaneLog < 200 || sComptonPlaneLog % 5000 == 0)) {
               G4cout << "[ScorePlane1][COMPTON_REDIRECTED] #" << sComptonPlaneLog
                      << " | particle: " << name << " (pdg=" << pdg << ")"
                      << " | trackID=" << trackID
@@ -235,7 +244,6 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
                          << pos.z()/mm << ")"
                      << G4endl;
           }
-          ++sComptonPlaneLog;
       }
 
       // ================================================================
@@ -246,6 +254,9 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
       //   - le volume logique où a eu lieu la réaction
       // ================================================================
       if (is_secondary) {
+        // Compteur du bilan (toujours) ; log limité : les 50 premiers puis 1 sur 1000
+        const G4long sSecLog = fLedger->Add(Ledger::kSpecSecondaries);
+        if (Diag::kEnabled && (sSecLog < 50 || sSecLog % 1000 == 0)) {
           // Position du vertex (lieu de création du secondaire)
           const G4ThreeVector& vtxPos = track->GetVertexPosition();
           const G4double vtx_x_mm = vtxPos.x() / mm;
@@ -265,29 +276,27 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
           // Énergie cinétique au vertex (énergie initiale du secondaire)
           const G4double vtx_ekin_keV = track->GetVertexKineticEnergy() / keV;
 
-          // Log limité : les 50 premiers puis 1 sur 1000
-          static G4int sSecLog = 0;
-          if (sSecLog < 50 || sSecLog % 1000 == 0) {
-              G4cout << "[ScorePlane1][SECONDARY_ORIGIN] #" << sSecLog
-                     << " | particle: " << name << " (pdg=" << pdg << ")"
-                     << " | trackID=" << trackID << " parentID=" << parentID
-                     << " | E_at_plane=" << E_keV << " keV"
-                     << " | creator_process: " << creator_process
-                     << " | vertex_pos(mm)=(" << vtx_x_mm << ", " << vtx_y_mm << ", " << vtx_z_mm << ")"
-                     << " | vertex_Ekin=" << vtx_ekin_keV << " keV"
-                     << " | vertex_volume: " << vtx_volume
-                     << " | vertex_material: " << vtx_material
-                     << G4endl;
-          }
-          ++sSecLog;
+          G4cout << "[ScorePlane1][SECONDARY_ORIGIN] #" << sSecLog
+                 << " | particle: " << name << " (pdg=" << pdg << ")"
+                 << " | trackID=" << trackID << " parentID=" << parentID
+                 << " | E_at_plane=" << E_keV << " keV"
+                 << " | creator_process: " << creator_process
+                 << " | vertex_pos(mm)=(" << vtx_x_mm << ", " << vtx_y_mm << ", " << vtx_z_mm << ")"
+                 << " | vertex_Ekin=" << vtx_ekin_keV << " keV"
+                 << " | vertex_volume: " << vtx_volume
+                 << " | vertex_material: " << vtx_material
+                 << G4endl;
+        }
       }
 
       // Log limité pour vérification (3 premiers seulement)
-      static int c=0, maxPrint=3;
-      if (c < maxPrint) {
-        G4cout << "[plane_passages][fill#" << (c+1) << "] pdg="<<pdg
-        << " x="<<x_mm<<" y="<<y_mm<<" E="<<E_keV<<" keV" << G4endl;
-        ++c;
+      constexpr G4long maxPrint = 3;
+      if constexpr (Diag::kEnabled) {
+        const G4long c = fLedger->Add(Ledger::kSpecLogFill);
+        if (c < maxPrint) {
+          G4cout << "[plane_passages][fill#" << (c+1) << "] pdg="<<pdg
+          << " x="<<x_mm<<" y="<<y_mm<<" E="<<E_keV<<" keV" << G4endl;
+        }
       }
       
       // Remplissage dans l'ordre des colonnes définies dans AnalysisManagerSetup.cc
@@ -307,17 +316,27 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
       man->FillNtupleDColumn(fPassageNtupleId, 12, compton_x_mm);    // Col 12: compton_x_mm (double)
       man->FillNtupleDColumn(fPassageNtupleId, 13, compton_y_mm);    // Col 13: compton_y_mm (double)
       man->FillNtupleDColumn(fPassageNtupleId, 14, compton_z_mm);    // Col 14: compton_z_mm (double)
+      man->FillNtupleDColumn(fPassageNtupleId, 15, weight);          // Col 15: weight (double)
       man->AddNtupleRow(fPassageNtupleId);
 
       // [ADD] rows counter and unique primary event marker
-      ++fCntRows;
+      fLedger->Add(Ledger::kSpecRows);
       {
+        // Un thread traite ses événements l'un après l'autre : il suffit de
+        // retenir le dernier eventID compté (les threads ont des événements disjoints).
+        // Événements multi-photons : un compte par primaire (eventID, rang)
         const auto* tr = step->GetTrack();
-        if (tr && tr->GetParentID() == 0) {
+        if (tr && MyTrackInfo::IsPrimary(tr)) {
           auto* rm = G4RunManager::GetRunManager();
           auto* ev = rm ? rm->GetCurrentEvent() : nullptr;
           const int eid = ev ? ev->GetEventID() : -1;
-          fEventsPrimaryCounted.insert(eid);
+          const auto* info = static_cast<const MyTrackInfo*>(tr->GetUserInformation());
+          const G4int slot = info ? info->GetPrimarySlot() : 0;
+          if (eid != fLastPrimaryEventCounted || slot != fLastPrimarySlotCounted) {
+            fLastPrimaryEventCounted = eid;
+            fLastPrimarySlotCounted = slot;
+            fLedger->Add(Ledger::kSpecPrimaryEvents);
+          }
         }
       }
 
@@ -340,12 +359,10 @@ G4bool SurfaceSpectrumSD::ProcessHits(G4Step* step, G4TouchableHistory*)
       // }
     } else {
       // [WARN] Diag utile si l’analysis est inactive (ne devrait plus arriver)
-      static int dbg_inactive = 0;
-      if (dbg_inactive < 10) {
+      if (fLedger->Add(Ledger::kSpecLogInactive) < 10) {
         G4cout << "[SpecSD][WARN] Analysis manager inactive — row NOT written"
         << " (ntupleId=" << fPassageNtupleId << ")"
         << G4endl;
-        ++dbg_inactive;
       }
     }
   }
@@ -362,14 +379,17 @@ void SurfaceSpectrumSD::EndOfEvent(G4HCofThisEvent*) {
 
 void SurfaceSpectrumSD::Reset() {
   std::fill(fBins.begin(), fBins.end(), 0.0);
+  fLastPrimaryEventCounted = -1;
 }
 
+// Bilan des compteurs du thread courant (le bilan fusionné est imprimé par
+// RunAction::EndOfRunAction via RunLedger::PrintSummary())
 void SurfaceSpectrumSD::PrintSummary() const {
-  G4cout << "[SpecSD][SUMMARY] enter=" << fCntEnter
-  << " leave=" << fCntLeave
-  << " outward=" << fCntOut
-  << " rows_written=" << fCntRows
-  << " unique_primary_events_counted=" << fEventsPrimaryCounted.size()
+  G4cout << "[SpecSD][SUMMARY] enter=" << fLedger->Get(Ledger::kSpecEnter)
+  << " leave=" << fLedger->Get(Ledger::kSpecLeave)
+  << " outward=" << fLedger->Get(Ledger::kSpecOut)
+  << " rows_written=" << fLedger->Get(Ledger::kSpecRows)
+  << " unique_primary_events_counted=" << fLedger->Get(Ledger::kSpecPrimaryEvents)
   << G4endl;
 }
 
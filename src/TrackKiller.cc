@@ -0,0 +1,44 @@
+#include "TrackKiller.hh"
+#include "TrackKillerMessenger.hh"
+
+#include "G4Threading.hh"
+
+// ==================== Configuration partagée ====================
+//  Bornes par défaut : corps du tube (z < 0) et au-delà de ScorePlane5
+//  (face aval à 70.5 mm, fond PVC à 69 mm)
+G4bool                TrackKiller::fEnabled   = false;
+G4bool                TrackKiller::fBackward  = true;
+G4double              TrackKiller::fBackwardZ = 0.*mm;
+G4bool                TrackKiller::fSide      = true;
+G4bool                TrackKiller::fBeyond    = true;
+G4double              TrackKiller::fBeyondZ   = 71.*mm;
+TrackKillerMessenger* TrackKiller::fMessenger = nullptr;
+
+void TrackKiller::Init()
+{
+    // Configuration commune à tous les threads : un seul messenger (master / SEQ)
+    if (G4Threading::IsMasterThread() && !fMessenger) fMessenger = new TrackKillerMessenger();
+}
+
+const char* TrackKiller::RuleName(G4int rule)
+{
+    switch (rule) {
+        case kBackward: return "backward";
+        case kSide:     return "side";
+        case kBeyond:   return "beyond";
+        default:        return "none";
+    }
+}
+
+void TrackKiller::BeginRun()
+{
+    if (!G4Threading::IsMasterThread()) return;
+
+    G4cout << "[KILL] Arrêt géométrique : " << (fEnabled ? "ACTIVÉ" : "désactivé");
+    if (fEnabled) {
+        G4cout << " | backward=" << (fBackward ? "on" : "off") << " (z < " << fBackwardZ/mm << " mm, dir.z <= 0)"
+               << " | side=" << (fSide ? "on" : "off") << " (|x|,|y| >= " << DetectorConstruction::kEnveloppeHalfXY/mm << " mm)"
+               << " | beyond=" << (fBeyond ? "on" : "off") << " (z >= " << fBeyondZ/mm << " mm, dir.z >= 0)";
+    }
+    G4cout << G4endl;
+}
@@ -0,0 +1,80 @@
+#include "TrackKillerMessenger.hh"
+#include "TrackKiller.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : la politique d'arrêt est
+//  partagée par tous les threads, les commandes ne sont donc pas retransmises.
+TrackKillerMessenger::TrackKillerMessenger()
+{
+    fDir = new G4UIdirectory("/killer/");
+    fDir->SetGuidance("Arrêt géométrique des tracks qui ne peuvent plus atteindre un scoreur.");
+
+    fEnableCmd = new G4UIcmdWithABool("/killer/enable", this);
+    fEnableCmd->SetGuidance("Active l'arrêt géométrique (évalué aux frontières, gamma/e-/e+).");
+    fEnableCmd->SetParameterName("on", false);
+    fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEnableCmd->SetToBeBroadcasted(false);
+
+    fBackwardCmd = new G4UIcmdWithABool("/killer/backward", this);
+    fBackwardCmd->SetGuidance("Règle backward : z < backwardZ et dir.z <= 0.");
+    fBackwardCmd->SetParameterName("on", false);
+    fBackwardCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBackwardCmd->SetToBeBroadcasted(false);
+
+    fBackwardZCmd = new G4UIcmdWithADoubleAndUnit("/killer/backwardZ", this);
+    fBackwardZCmd->SetGuidance("Plan z sous lequel un track qui recule est arrêté.");
+    fBackwardZCmd->SetParameterName("z", false);
+    fBackwardZCmd->SetDefaultUnit("mm");
+    fBackwardZCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBackwardZCmd->SetToBeBroadcasted(false);
+
+    fSideCmd = new G4UIcmdWithABool("/killer/side", this);
+    fSideCmd->SetGuidance("Règle side : sortie latérale de l'enveloppe (|x| ou |y| >= 50 mm, vers l'extérieur).");
+    fSideCmd->SetParameterName("on", false);
+    fSideCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fSideCmd->SetToBeBroadcasted(false);
+
+    fBeyondCmd = new G4UIcmdWithABool("/killer/beyond", this);
+    fBeyondCmd->SetGuidance("Règle beyond : z >= beyondZ et dir.z >= 0 (après le dernier scoreur).");
+    fBeyondCmd->SetParameterName("on", false);
+    fBeyondCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBeyondCmd->SetToBeBroadcasted(false);
+
+    fBeyondZCmd = new G4UIcmdWithADoubleAndUnit("/killer/beyondZ", this);
+    fBeyondZCmd->SetGuidance("Plan z au-delà duquel un track qui avance est arrêté.");
+    fBeyondZCmd->SetParameterName("z", false);
+    fBeyondZCmd->SetDefaultUnit("mm");
+    fBeyondZCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBeyondZCmd->SetToBeBroadcasted(false);
+}
+
+TrackKillerMessenger::~TrackKillerMessenger()
+{
+    delete fEnableCmd;
+    delete fBackwardCmd;
+    delete fBackwardZCmd;
+    delete fSideCmd;
+    delete fBeyondCmd;
+    delete fBeyondZCmd;
+    delete fDir;
+}
+
+void TrackKillerMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fEnableCmd) {
+        TrackKiller::SetEnabled(fEnableCmd->GetNewBoolValue(value));
+    } else if (command == fBackwardCmd) {
+        TrackKiller::SetBackward(fBackwardCmd->GetNewBoolValue(value));
+    } else if (command == fBackwardZCmd) {
+        TrackKiller::SetBackwardZ(fBackwardZCmd->GetNewDoubleValue(value));
+    } else if (command == fSideCmd) {
+        TrackKiller::SetSide(fSideCmd->GetNewBoolValue(value));
+    } else if (command == fBeyondCmd) {
+        TrackKiller::SetBeyond(fBeyondCmd->GetNewBoolValue(value));
+    } else if (command == fBeyondZCmd) {
+        TrackKiller::SetBeyondZ(fBeyondZCmd->GetNewDoubleValue(value));
+    }
+}
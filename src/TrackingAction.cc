@@ -1,21 +1,110 @@
 #include "TrackingAction.hh"
+#include "TrackingMessenger.hh"
+#include "MyTrackInfo.hh"
+#include "StepTracer.hh"
+#include "RunLedger.hh"
+#include "PrimaryGeneratorAction.hh"
+
 #include "G4Track.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ThreeVector.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4RunManager.hh"
 
 #include "G4TrackingManager.hh"
 #include "G4Trajectory.hh"
 
-TrackingAction::TrackingAction() {}
+TrackingAction::TrackingAction(TrajectoryMode mode)
+: fMode(mode),
+  fTracer(StepTracer::Instance()),  // instance du thread qui exécute les tracks
+  fLedger(RunLedger::Instance())
+{
+    fTrackingMessenger = new TrackingMessenger(this);
+}
+
+TrackingAction::~TrackingAction()
+{
+    delete fTrackingMessenger;
+}
+
+const char* TrackingAction::ModeName(TrajectoryMode mode)
+{
+    switch (mode) {
+        case kOn:      return "on";
+        case kSampled: return "sampled";
+        default:       return "off";
+    }
+}
+
+void TrackingAction::AssignPrimarySlot(const G4Track* track, MyTrackInfo* info)
+{
+    // Un seul primaire par événement : rang 0 partout, pas de table
+    const auto* generator = static_cast<const PrimaryGeneratorAction*>(
+        G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+    if (!generator || generator->GetNbPrimarySlots() <= 1) return;
+
+    const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+    const G4int eventID = event ? event->GetEventID() : -1;
+    if (eventID != fSlotEventID) {
+        fSlotEventID = eventID;
+        fSlotOfTrack.clear();
+    }
+
+    // Primaire : rang tiré par PrimaryGeneratorAction ; secondaire (ou clone de
+    // biais, dont l'info est copiée) : rang du parent
+    const G4int trackID  = track->GetTrackID();
+    const G4int parentID = track->GetParentID();
+    G4int slot = 0;
+    if (parentID == 0) {
+        slot = generator->GetPrimarySlot(trackID);
+    } else if (parentID < static_cast<G4int>(fSlotOfTrack.size())) {
+        slot = fSlotOfTrack[parentID];
+    }
+    info->SetPrimarySlot(slot);
+
+    if (trackID >= static_cast<G4int>(fSlotOfTrack.size())) fSlotOfTrack.resize(trackID + 1, 0);
+    fSlotOfTrack[trackID] = slot;
+}
 
 void TrackingAction::PreUserTrackingAction(const G4Track* track)
 {
+    // [ADD] MyTrackInfo de chaque track, alloué dans le pool du thread :
+    //       processus créateur (pointeur) et marquage du suivi step par step
+    fLedger->Add(Ledger::kTracks);
+
+    auto* info = static_cast<MyTrackInfo*>(track->GetUserInformation());
+    if (!info) {
+        info = new MyTrackInfo(track->GetCreatorProcess());
+        info->SetTraced(fTracer->IsActive());
+        fpTrackingManager->SetUserTrackInformation(info);
+    }
+    AssignPrimarySlot(track, info);
+
+    G4bool store = (fMode == kOn);
+
+    if (fMode == kSampled) {
+        // Une décision par événement (tous les tracks de l'événement, ou aucun)
+        const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+        const G4int eventID = event ? event->GetEventID() : -1;
+        if (eventID != fLastEventID) {
+            fLastEventID = eventID;
+            fStoreThisEvent = (eventID >= 0 && eventID % fEvery == 0);
+        }
+        store = fStoreThisEvent;
+    }
+
+    if (!store) {
+        // [FIX] Batch : pas de trajectoire (ni allocation, ni stockage de points),
+        //       y compris si /tracking/storeTrajectory a été activé par /vis/
+        fpTrackingManager->SetStoreTrajectory(0);
+        return;
+    }
+
     // Demande à Geant4 de stocker les trajectoires
-    fpTrackingManager->SetStoreTrajectory(true);
+    fpTrackingManager->SetStoreTrajectory(1);
 
     // Crée une nouvelle trajectoire basée sur la particule suivie
     fpTrackingManager->SetTrajectory(new G4Trajectory(track));
 }
-
-
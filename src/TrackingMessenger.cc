@@ -0,0 +1,45 @@
+#include "TrackingMessenger.hh"
+#include "TrackingAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+TrackingMessenger::TrackingMessenger(TrackingAction* tracking)
+: fTracking(tracking)
+{
+    fDir = new G4UIdirectory("/trajectories/");
+    fDir->SetGuidance("Stockage des trajectoires (TrackingAction).");
+
+    fModeCmd = new G4UIcmdWithAString("/trajectories/mode", this);
+    fModeCmd->SetGuidance("on : une trajectoire par track (visualisation)");
+    fModeCmd->SetGuidance("off : aucune trajectoire (batch)");
+    fModeCmd->SetGuidance("sampled : trajectoires d'un événement sur N (/trajectories/every)");
+    fModeCmd->SetParameterName("mode", false);
+    fModeCmd->SetCandidates("on off sampled");
+    fModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEveryCmd = new G4UIcmdWithAnInteger("/trajectories/every", this);
+    fEveryCmd->SetGuidance("Mode sampled : stocker les trajectoires d'un événement sur N.");
+    fEveryCmd->SetParameterName("n", false);
+    fEveryCmd->SetRange("n>=1");
+    fEveryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+TrackingMessenger::~TrackingMessenger()
+{
+    delete fModeCmd;
+    delete fEveryCmd;
+    delete fDir;
+}
+
+void TrackingMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fModeCmd) {
+        if      (value == "on")      fTracking->SetTrajectoryMode(TrackingAction::kOn);
+        else if (value == "sampled") fTracking->SetTrajectoryMode(TrackingAction::kSampled);
+        else                         fTracking->SetTrajectoryMode(TrackingAction::kOff);
+    } else if (command == fEveryCmd) {
+        fTracking->SetTrajectoryEvery(fEveryCmd->GetNewIntValue(value));
+    }
+}
@@ -0,0 +1,210 @@
+#include "TubeSourceModel.hh"
+#include "TubeSourceModelMessenger.hh"
+#include "PrimaryGeneratorAction2.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    G4Mutex gTubeSourceMutex = G4MUTEX_INITIALIZER;
+
+    // Plan du foyer par défaut : celui de la source ponctuelle (z = +1 µm)
+    constexpr G4double kDefaultSpotZ = 0.001*mm;
+
+    // Valeur d'une clé de commentaire "# clé: valeur"
+    G4bool ParseKey(const std::string& line, const std::string& key, G4double& value)
+    {
+        const auto pos = line.find(key + ":");
+        if (pos == std::string::npos) return false;
+        value = std::atof(line.c_str() + pos + key.size() + 1);
+        return true;
+    }
+
+    G4bool IsComment(const std::string& line, G4bool& blank)
+    {
+        const auto first = line.find_first_not_of(" \t\r");
+        blank = (first == std::string::npos);
+        return !blank && line[first] == '#';
+    }
+
+    void Warn(const char* code, const G4String& file, const G4String& what)
+    {
+        G4ExceptionDescription ed;
+        ed << file << " : " << what;
+        G4Exception("TubeSourceModel", code, JustWarning, ed);
+    }
+}
+
+// ==================== Tables partagées ====================
+std::vector<std::unique_ptr<TubeSourceModel::FocalSpot>> TubeSourceModel::fFocalSpots;
+std::vector<std::unique_ptr<TubeSourceModel::HeelTable>> TubeSourceModel::fHeelTables;
+const TubeSourceModel::FocalSpot* TubeSourceModel::fFocalSpot = nullptr;
+const TubeSourceModel::HeelTable* TubeSourceModel::fHeelTable = nullptr;
+TubeSourceModelMessenger* TubeSourceModel::fMessenger = nullptr;
+
+void TubeSourceModel::Init()
+{
+    // Tables communes à tous les threads : messenger unique (master / SEQ)
+    if (!G4Threading::IsMasterThread() || fMessenger) return;
+    fMessenger = new TubeSourceModelMessenger();
+}
+
+// ==================== Foyer ====================
+G4bool TubeSourceModel::LoadFocalSpot(const G4String& file)
+{
+    std::ifstream in(file);
+    if (!in) { Warn("TUBE001", file, "fichier introuvable, foyer inchangé."); return false; }
+
+    auto spot = std::make_unique<FocalSpot>();
+    spot->file = file;
+    spot->z = kDefaultSpotZ;
+
+    std::vector<G4double> weights;
+    std::string line;
+    while (std::getline(in, line)) {
+        G4bool blank = false;
+        if (IsComment(line, blank)) {
+            G4double v = 0.;
+            if (ParseKey(line, "dx_mm", v)) spot->dx = v*mm;
+            else if (ParseKey(line, "dy_mm", v)) spot->dy = v*mm;
+            else if (ParseKey(line, "z_mm", v)) spot->z = v*mm;
+            continue;
+        }
+        if (blank) continue;
+
+        std::istringstream iss(line);
+        std::uint32_t n = 0;
+        G4double w = 0.;
+        while (iss >> w) {
+            if (w < 0.) { Warn("TUBE002", file, "intensité négative, foyer ignoré."); return false; }
+            weights.push_back(w);
+            ++n;
+        }
+        if (spot->nx == 0) spot->nx = n;
+        if (n != spot->nx || !iss.eof()) {
+            Warn("TUBE002", file, "lignes de longueurs différentes ou non numériques, foyer ignoré.");
+            return false;
+        }
+        ++spot->ny;
+    }
+    if (!(spot->dx > 0.) || !(spot->dy > 0.) || spot->nx == 0) {
+        Warn("TUBE002", file, "dx_mm / dy_mm manquants ou carte vide, foyer ignoré.");
+        return false;
+    }
+
+    // Grille centrée sur l'axe du tube ; seuls les pixels non nuls sont gardés
+    spot->x0 = -0.5*spot->nx*spot->dx;
+    spot->y0 = -0.5*spot->ny*spot->dy;
+    std::vector<G4double> kept;
+    for (std::uint32_t p = 0; p < weights.size(); ++p) {
+        if (weights[p] > 0.) { spot->pixels.push_back(p); kept.push_back(weights[p]); }
+    }
+    spot->alias.Build(kept);
+    if (spot->alias.Empty()) { Warn("TUBE002", file, "carte d'intensité nulle, foyer ignoré."); return false; }
+
+    G4AutoLock lock(&gTubeSourceMutex);
+    fFocalSpot = spot.get();
+    fFocalSpots.push_back(std::move(spot));
+    return true;
+}
+
+// ==================== Effet talon ====================
+G4bool TubeSourceModel::LoadHeelTable(const G4String& file)
+{
+    std::ifstream in(file);
+    if (!in) { Warn("TUBE003", file, "fichier introuvable, table inchangée."); return false; }
+
+    auto heel = std::make_unique<HeelTable>();
+    heel->file = file;
+
+    // Points (E, I) regroupés par angle
+    std::vector<std::vector<G4double>> xs, ys;
+    std::string line;
+    while (std::getline(in, line)) {
+        G4bool blank = false;
+        if (IsComment(line, blank) || blank) continue;
+
+        std::istringstream iss(line);
+        G4double th = 0., e = 0., w = 0.;
+        if (!(iss >> th >> e >> w) || w < 0. || th < 0. || th >= 90.) {
+            Warn("TUBE004", file, "ligne invalide (theta en [0,90[ deg, intensités >= 0) : \"" + line + "\"");
+            return false;
+        }
+        th *= deg;
+        if (heel->theta.empty() || th != heel->theta.back()) {
+            if (!heel->theta.empty() && th < heel->theta.back()) {
+                Warn("TUBE004", file, "angles non croissants, table ignorée.");
+                return false;
+            }
+            heel->theta.push_back(th);
+            xs.emplace_back();
+            ys.emplace_back();
+        }
+        if (!xs.back().empty() && e*keV <= xs.back().back()) {
+            Warn("TUBE004", file, "énergies non croissantes pour un angle, table ignorée.");
+            return false;
+        }
+        xs.back().push_back(e*keV);
+        ys.back().push_back(w);
+    }
+
+    const std::size_t n = heel->theta.size();
+    if (n < 2) { Warn("TUBE004", file, "au moins deux angles sont nécessaires, table ignorée."); return false; }
+
+    heel->spectra.resize(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        heel->cosTheta.push_back(std::cos(heel->theta[k]));
+        heel->spectra[k].Build(xs[k], ys[k], PrimaryGeneratorAction2::kEcut);
+        heel->yield.push_back(heel->spectra[k].Integral());
+    }
+
+    // Terme e de l'intervalle k : intégrale de (1-t) S_k ou t S_k+1 sur dOmega = 2 pi dmu,
+    // soit pi * (cos theta_k - cos theta_k+1) * yield (facteur pi commun omis)
+    std::vector<G4double> weights(2*(n - 1));
+    for (std::size_t k = 0; k + 1 < n; ++k) {
+        const G4double dmu = heel->cosTheta[k] - heel->cosTheta[k + 1];
+        weights[2*k]     = dmu * heel->yield[k];
+        weights[2*k + 1] = dmu * heel->yield[k + 1];
+    }
+    heel->alias.Build(weights);
+    if (heel->alias.Empty()) {
+        Warn("TUBE004", file, "aucune intensité au-dessus de kEcut, table ignorée.");
+        return false;
+    }
+
+    G4AutoLock lock(&gTubeSourceMutex);
+    fHeelTable = heel.get();
+    fHeelTables.push_back(std::move(heel));
+    return true;
+}
+
+void TubeSourceModel::Print()
+{
+    G4AutoLock lock(&gTubeSourceMutex);
+    G4cout << "[TUBE] Source 5 (foyer + effet talon)" << G4endl;
+    if (fFocalSpot) {
+        const auto& s = *fFocalSpot;
+        G4cout << "  foyer  : " << s.file << " | " << s.nx << " x " << s.ny << " pixels de "
+               << s.dx/um << " x " << s.dy/um << " um | " << s.pixels.size() << " non nuls"
+               << " | z=" << s.z/mm << " mm" << G4endl;
+    } else {
+        G4cout << "  foyer  : non chargé (source ponctuelle sur l'axe)" << G4endl;
+    }
+    if (fHeelTable) {
+        const auto& h = *fHeelTable;
+        G4cout << "  talon  : " << h.file << " | " << h.theta.size() << " angles de "
+               << h.theta.front()/deg << " à " << h.theta.back()/deg << " deg" << G4endl;
+        for (std::size_t k = 0; k < h.theta.size(); ++k) {
+            G4cout << "    theta=" << h.theta[k]/deg << " deg | intensité relative="
+                   << ((h.yield.front() > 0.) ? h.yield[k]/h.yield.front() : 0.)
+                   << " | <E>=" << h.spectra[k].Mean()/keV << " keV" << G4endl;
+        }
+    } else {
+        G4cout << "  talon  : non chargé (/tubesource/heelTable requis pour la source 5)" << G4endl;
+    }
+}
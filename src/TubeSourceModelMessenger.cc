@@ -0,0 +1,50 @@
+#include "TubeSourceModelMessenger.hh"
+#include "TubeSourceModel.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//  Messenger créé une seule fois (master / SEQ) : les tables sont partagées
+//  par tous les threads, les commandes ne sont donc pas retransmises.
+TubeSourceModelMessenger::TubeSourceModelMessenger()
+{
+    fDir = new G4UIdirectory("/tubesource/");
+    fDir->SetGuidance("Source 5 : foyer 2D et effet talon tabulés (sans simulation du tube).");
+
+    fFocalSpotCmd = new G4UIcmdWithAString("/tubesource/focalSpot", this);
+    fFocalSpotCmd->SetGuidance("Carte d'intensité du foyer (grille, # dx_mm / # dy_mm).");
+    fFocalSpotCmd->SetParameterName("file", false);
+    fFocalSpotCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fFocalSpotCmd->SetToBeBroadcasted(false);
+
+    fHeelTableCmd = new G4UIcmdWithAString("/tubesource/heelTable", this);
+    fHeelTableCmd->SetGuidance("Spectres par angle d'émission : theta(deg) E(keV) I(/sr/keV).");
+    fHeelTableCmd->SetParameterName("file", false);
+    fHeelTableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fHeelTableCmd->SetToBeBroadcasted(false);
+
+    fPrintCmd = new G4UIcmdWithoutParameter("/tubesource/print", this);
+    fPrintCmd->SetGuidance("Affiche les tables chargées.");
+    fPrintCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fPrintCmd->SetToBeBroadcasted(false);
+}
+
+TubeSourceModelMessenger::~TubeSourceModelMessenger()
+{
+    delete fFocalSpotCmd;
+    delete fHeelTableCmd;
+    delete fPrintCmd;
+    delete fDir;
+}
+
+void TubeSourceModelMessenger::SetNewValue(G4UIcommand* command, G4String value)
+{
+    if (command == fFocalSpotCmd) {
+        if (TubeSourceModel::LoadFocalSpot(value)) TubeSourceModel::Print();
+    } else if (command == fHeelTableCmd) {
+        if (TubeSourceModel::LoadHeelTable(value)) TubeSourceModel::Print();
+    } else if (command == fPrintCmd) {
+        TubeSourceModel::Print();
+    }
+}
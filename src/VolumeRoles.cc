@@ -0,0 +1,93 @@
+#include "VolumeRoles.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4LogicalVolumeStore.hh"
+#include "G4Material.hh"
+
+#include <string>
+
+std::vector<VolumeInfo> VolumeRoles::fTable;
+const VolumeInfo VolumeRoles::fUnknown{};
+
+namespace {
+    // Index de couronne à partir du suffixe de "logicWaterRingN" (-1 si invalide)
+    G4int ParseRingIndex(const G4String& name, std::size_t prefixLen)
+    {
+        if (name.size() <= prefixLen) return -1;
+        G4int idx = 0;
+        for (std::size_t i = prefixLen; i < name.size(); ++i) {
+            const char c = name[i];
+            if (c < '0' || c > '9') return -1;
+            idx = 10*idx + (c - '0');
+        }
+        return (idx < DetectorConstruction::kNbWaterRings) ? idx : -1;
+    }
+}
+
+void VolumeRoles::Build()
+{
+    using namespace VolumeRole;
+
+    static const std::string kRingPrefix = "logicWaterRing";
+
+    const auto* lvStore = G4LogicalVolumeStore::GetInstance();
+
+    G4int maxID = -1;
+    for (const auto* lv : *lvStore) {
+        if (lv && lv->GetInstanceID() > maxID) maxID = lv->GetInstanceID();
+    }
+
+    fTable.assign(static_cast<std::size_t>(maxID + 1), VolumeInfo{});
+
+    for (const auto* lv : *lvStore) {
+        if (!lv) continue;
+        VolumeInfo& info = fTable[static_cast<std::size_t>(lv->GetInstanceID())];
+
+        const G4String& name = lv->GetName();
+        if      (name == "MiniX-TubeXFenetreBeryllium-Beryllium") info.role = kBeWindow;
+        else if (name == "logicScorePlane")                       info.role = kScorePlane;
+        else if (name == "logicConeCompton")                      info.role = kConeCompton;
+        else if (name == "logicEnveloppeGDML")                    info.role = kEnveloppe;
+        else if (name == "logicWaterCube")                        info.role = kWaterCube;
+        else if (name == "logicsphereWater")                      info.role = kSphereWater;
+        else if (name.compare(0, kRingPrefix.size(), kRingPrefix) == 0) {
+            info.ringIndex = ParseRingIndex(name, kRingPrefix.size());
+            if (info.ringIndex >= 0) info.role = kWaterRing;
+        }
+
+        const G4Material* mat = lv->GetMaterial();
+        info.isStainless = (mat && mat->GetName() == "StainlessSteel304");
+    }
+
+    Print();
+}
+
+const char* VolumeRoles::RoleName(G4int role)
+{
+    switch (role) {
+        case VolumeRole::kBeWindow:    return "BeWindow";
+        case VolumeRole::kScorePlane:  return "ScorePlane";
+        case VolumeRole::kWaterRing:   return "WaterRing";
+        case VolumeRole::kConeCompton: return "ConeCompton";
+        case VolumeRole::kEnveloppe:   return "Enveloppe";
+        case VolumeRole::kWaterCube:   return "WaterCube";
+        case VolumeRole::kSphereWater: return "SphereWater";
+        default:                       return "Other";
+    }
+}
+
+void VolumeRoles::Print()
+{
+    G4cout << "\n=== [VolumeRoles] Table des rôles (" << fTable.size() << " volumes logiques) ===" << G4endl;
+    for (const auto* lv : *G4LogicalVolumeStore::GetInstance()) {
+        if (!lv) continue;
+        const VolumeInfo& info = Of(lv);
+        if (info.role == VolumeRole::kOther && !info.isStainless) continue;
+        G4cout << " - [" << lv->GetInstanceID() << "] " << lv->GetName()
+               << " : " << RoleName(info.role);
+        if (info.ringIndex >= 0) G4cout << " #" << info.ringIndex;
+        if (info.isStainless)    G4cout << " (inox)";
+        G4cout << G4endl;
+    }
+    G4cout << "=====================================================\n" << G4endl;
+}
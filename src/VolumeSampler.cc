@@ -0,0 +1,79 @@
+#include "VolumeSampler.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Garde-fou mémoire / temps de construction : la grille est élargie au-delà
+    constexpr G4double kMaxGridVoxels = 8.e6;
+}
+
+G4bool VolumeSampler::Build(const G4LogicalVolume* volume, const G4ThreeVector& lo,
+                            const G4ThreeVector& hi, G4double voxelSize, G4int pointsPerAxis)
+{
+    return Build(volume ? volume->GetSolid() : nullptr, lo, hi, voxelSize, pointsPerAxis);
+}
+
+G4bool VolumeSampler::Build(const G4VSolid* solid, const G4ThreeVector& lo,
+                            const G4ThreeVector& hi, G4double voxelSize, G4int pointsPerAxis)
+{
+    fVoxels.clear();
+    fAlias = AliasTable();
+    fVolume = 0.;
+    fNx = fNy = fNz = 0;
+    if (!solid || !(voxelSize > 0.)) return false;
+
+    // Fenêtre restreinte à l'extent du solide
+    const G4VisExtent ext = solid->GetExtent();
+    fLo.set(std::max(lo.x(), ext.GetXmin()), std::max(lo.y(), ext.GetYmin()),
+            std::max(lo.z(), ext.GetZmin()));
+    fHi.set(std::min(hi.x(), ext.GetXmax()), std::min(hi.y(), ext.GetYmax()),
+            std::min(hi.z(), ext.GetZmax()));
+    const G4ThreeVector size = fHi - fLo;
+    if (!(size.x() > 0.) || !(size.y() > 0.) || !(size.z() > 0.)) return false;
+
+    G4double pitch = voxelSize;
+    const G4double nTot = std::ceil(size.x()/pitch) * std::ceil(size.y()/pitch) * std::ceil(size.z()/pitch);
+    if (nTot > kMaxGridVoxels) pitch *= std::cbrt(nTot / kMaxGridVoxels);
+
+    // Nombre entier de voxels par axe, pas ajusté pour couvrir exactement la fenêtre
+    fNx = static_cast<std::uint32_t>(std::max(1., std::ceil(size.x()/pitch - 1.e-9)));
+    fNy = static_cast<std::uint32_t>(std::max(1., std::ceil(size.y()/pitch - 1.e-9)));
+    fNz = static_cast<std::uint32_t>(std::max(1., std::ceil(size.z()/pitch - 1.e-9)));
+    fPitch.set(size.x()/fNx, size.y()/fNy, size.z()/fNz);
+
+    // k^3 points au centre des sous-cellules de chaque voxel
+    const G4int k = std::max(1, pointsPerAxis);
+    const G4double nPoints = G4double(k)*k*k;
+    const G4double voxelVolume = fPitch.x()*fPitch.y()*fPitch.z();
+
+    std::vector<G4double> weights;
+    for (std::uint32_t iz = 0; iz < fNz; ++iz) {
+        for (std::uint32_t iy = 0; iy < fNy; ++iy) {
+            for (std::uint32_t ix = 0; ix < fNx; ++ix) {
+                G4int nIn = 0;
+                for (G4int a = 0; a < k; ++a) {
+                    for (G4int b = 0; b < k; ++b) {
+                        for (G4int c = 0; c < k; ++c) {
+                            const G4ThreeVector p(fLo.x() + (ix + (a + 0.5)/k)*fPitch.x(),
+                                                  fLo.y() + (iy + (b + 0.5)/k)*fPitch.y(),
+                                                  fLo.z() + (iz + (c + 0.5)/k)*fPitch.z());
+                            if (solid->Inside(p) != kOutside) ++nIn;
+                        }
+                    }
+                }
+                if (nIn == 0) continue;
+                fVoxels.push_back(ix + fNx*(iy + fNy*iz));
+                weights.push_back(nIn / nPoints);
+                fVolume += voxelVolume * nIn / nPoints;
+            }
+        }
+    }
+
+    fAlias.Build(weights);
+    return !fAlias.Empty();
+}
@@ -0,0 +1,37 @@
+#include "WaterMuEn.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+    // NIST, eau liquide : E (MeV), mu_en/rho (cm2/g)
+    constexpr G4double kE[] = {
+        1.0e-3, 1.5e-3, 2.0e-3, 3.0e-3, 4.0e-3, 5.0e-3, 6.0e-3, 8.0e-3,
+        1.0e-2, 1.5e-2, 2.0e-2, 3.0e-2, 4.0e-2, 5.0e-2, 6.0e-2, 8.0e-2,
+        1.0e-1, 1.5e-1, 2.0e-1, 3.0e-1, 4.0e-1, 5.0e-1, 6.0e-1, 8.0e-1,
+        1.0,    1.25,   1.5,    2.0
+    };
+    constexpr G4double kMuEn[] = {
+        4.065e+3, 1.372e+3, 6.152e+2, 1.917e+2, 8.191e+1, 4.188e+1, 2.405e+1, 9.915e+0,
+        4.944e+0, 1.374e+0, 5.503e-1, 1.557e-1, 6.947e-2, 4.223e-2, 3.190e-2, 2.597e-2,
+        2.546e-2, 2.764e-2, 2.967e-2, 3.192e-2, 3.279e-2, 3.299e-2, 3.284e-2, 3.206e-2,
+        3.103e-2, 2.965e-2, 2.833e-2, 2.608e-2
+    };
+    constexpr std::size_t kN = std::size(kE);
+    static_assert(std::size(kMuEn) == kN, "WaterMuEn : tables de tailles différentes");
+}
+
+G4double WaterMuEn::MassEnergyAbsorption(G4double e)
+{
+    const G4double eMeV = e / MeV;
+    if (eMeV <= kE[0])      return kMuEn[0] * cm2/g;
+    if (eMeV >= kE[kN - 1]) return kMuEn[kN - 1] * cm2/g;
+
+    // Intervalle [kE[i-1], kE[i]] puis interpolation log-log
+    const std::size_t i = std::upper_bound(kE, kE + kN, eMeV) - kE;
+    const G4double t = std::log(eMeV / kE[i - 1]) / std::log(kE[i] / kE[i - 1]);
+    return kMuEn[i - 1] * std::pow(kMuEn[i] / kMuEn[i - 1], t) * cm2/g;
+}